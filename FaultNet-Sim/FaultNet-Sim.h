@@ -4,8 +4,17 @@
 #include "DataInterface.h"
 #include "Global.h"
 #include "Distribution.h"
+#include "CounterRNG.h"
 #include "SensorNode.h"
+#include "EventQueue.h"
+#include "SensorNodeTable.h"
+#include "PacketStore.h"
+#include "PathCostTable.h"
+#include "TreeSnapshot.h"
+#include "SimulationPartition.h"
 #include "Simulator.h"
+#include "SimulationPolicy.h"
+#include "PolicySimulator.h"
 #include "Problem.h"
 #include "DatabaseData.h"
 #include "SQLiteDatabase.h"
\ No newline at end of file
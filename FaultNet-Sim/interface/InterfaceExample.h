@@ -15,7 +15,20 @@ namespace FaultNet_Sim
 	};
 
 
-	class ExampleSimulator : public Simulator
+	// Draws the delta of every SN uniformly instead of using the round-robin schedule,
+	// everything else is inherited from the default policy.
+	class ExamplePolicy : public SimulationPolicy<ExamplePolicy>
+	{
+	public:
+		void SetSNDeltas(std::vector<SensorNode>& SNs, const SimulatorParameters& sp);
+
+		inline bool IsDone(const SimulatorParameters& sp, double currentTime)
+		{
+			return currentTime >= sp.TotalSimulationTime;
+		}
+	};
+
+	class ExampleSimulator : public PolicySimulator<ExamplePolicy>
 	{
 	public:
 		ExampleSimulator(SimulatorParameters sp, std::string description);
@@ -29,17 +42,5 @@ namespace FaultNet_Sim
 		{
 			return "ExampleSimulator";
 		}
-
-	protected:
-
-		virtual void ConstructTopology() override;
-		virtual void ColorTopology() override;
-		virtual void SetSNDeltas() override;
-
-		virtual bool IsDone(double currentTime) override;
-
-
-		virtual void Simulate() override;
-
 	};
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "PCH.h"
+#include "CounterRNG.h"
+
+namespace FaultNet_Sim
+{
+	uint64_t s_MasterSeed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+	std::string RandomStreamToString(const RandomStream& rs)
+	{
+		switch (rs)
+		{
+		case RandomStream::Failures:
+			return "Failures";
+		case RandomStream::Deltas:
+			return "Deltas";
+		}
+
+		throw std::runtime_error("Unknown Random Stream in RandomStreamToString!");
+		return "";
+	}
+
+	void CounterRNG::Seek(uint64_t index)
+	{
+		m_Block = index / 2;
+		Generate(m_Block++);
+		m_Used = (int)(index % 2);
+	}
+
+	uint64_t CounterRNG::Key(uint64_t masterSeed, int64_t problemID, int64_t sn)
+	{
+		uint32_t counter[4] = { (uint32_t)sn, (uint32_t)((uint64_t)sn >> 32), (uint32_t)problemID, (uint32_t)((uint64_t)problemID >> 32) };
+		Philox(counter, (uint32_t)masterSeed, (uint32_t)(masterSeed >> 32));
+		return (uint64_t)counter[1] << 32 | counter[0];
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+namespace FaultNet_Sim
+{
+	// Master seed the random key of every SN is derived from, seeded from the clock like s_RNG.
+	extern uint64_t s_MasterSeed;
+
+	// What a stream of an SN is used for, so that each use draws its own numbers.
+	enum class RandomStream
+	{
+		Failures = 0,
+		Deltas
+	};
+
+	std::string RandomStreamToString(const RandomStream& rs);
+
+	// Philox4x32-10 counter-based engine. Draw i of a stream is a pure function of the key,
+	// the stream and i, so engines need no shared state, any number of them can draw in
+	// parallel, and any draw can be regenerated without the ones before it.
+	class CounterRNG
+	{
+	public:
+		using result_type = uint64_t;
+
+		CounterRNG(uint64_t key = 0, RandomStream stream = RandomStream::Failures)
+			: m_Key(key), m_Stream((uint32_t)stream) {}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+		inline result_type operator()()
+		{
+			if (m_Used == 2)
+			{
+				Generate(m_Block++);
+				m_Used = 0;
+			}
+			return m_Output[m_Used++];
+		}
+
+		// Continues with draw index, counting from 0.
+		void Seek(uint64_t index);
+
+		// Key of the streams of SN sn of problem problemID.
+		static uint64_t Key(uint64_t masterSeed, int64_t problemID, int64_t sn);
+
+	private:
+		static inline void Philox(uint32_t counter[4], uint32_t key0, uint32_t key1)
+		{
+			for (int round = 0; round < 10; round++)
+			{
+				uint64_t product0 = (uint64_t)0xD2511F53u * counter[0];
+				uint64_t product1 = (uint64_t)0xCD9E8D57u * counter[2];
+
+				uint32_t next0 = (uint32_t)(product1 >> 32) ^ counter[1] ^ key0;
+				uint32_t next2 = (uint32_t)(product0 >> 32) ^ counter[3] ^ key1;
+				counter[0] = next0;
+				counter[1] = (uint32_t)product1;
+				counter[2] = next2;
+				counter[3] = (uint32_t)product0;
+
+				key0 += 0x9E3779B9u;
+				key1 += 0xBB67AE85u;
+			}
+		}
+
+		inline void Generate(uint64_t block)
+		{
+			uint32_t counter[4] = { (uint32_t)block, (uint32_t)(block >> 32), m_Stream, 0 };
+			Philox(counter, (uint32_t)m_Key, (uint32_t)(m_Key >> 32));
+			m_Output[0] = (uint64_t)counter[1] << 32 | counter[0];
+			m_Output[1] = (uint64_t)counter[3] << 32 | counter[2];
+		}
+
+		uint64_t m_Key;
+		uint32_t m_Stream;
+		uint64_t m_Block = 0;
+		uint64_t m_Output[2] = { 0, 0 };
+		int m_Used = 2;
+	};
+}
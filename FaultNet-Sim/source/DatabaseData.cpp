@@ -48,6 +48,7 @@ namespace FaultNet_Sim
 		simulatorData.TransmissionRange = sp.TransmissionRange;
 		simulatorData.InterferenceRange = sp.InterferenceRange;
 		simulatorData.TransferredTotalDuration = simulator.GetTransferredTotalDuration();
+		simulatorData.ColorCount = simulator.GetSimulatorResults().ColorCount;
 
 		memcpy(&data.m_Data[0], &simulatorData, sizeof(SimulatorData));
 		return data;
@@ -59,14 +60,19 @@ namespace FaultNet_Sim
 		data.m_DataType = DataType::SensorNodeData;
 		data.m_Data = std::vector<std::byte>(sizeof(SensorNodeData));
 		double failureMean = 0.0;
-		for (int j = 0; j < sn.m_FailureTimestamps.size(); j++)
+		if (sn.m_TimeBetweenFailures)
+			failureMean = sn.m_TimeBetweenFailures->m_Mean;
+		else
 		{
-			if (j == 0)
-				failureMean += sn.m_FailureTimestamps[j];
-			else
-				failureMean += sn.m_FailureTimestamps[j] - sn.m_FailureTimestamps[j - 1];
+			for (int j = 0; j < sn.m_FailureTimestamps.size(); j++)
+			{
+				if (j == 0)
+					failureMean += sn.m_FailureTimestamps[j];
+				else
+					failureMean += sn.m_FailureTimestamps[j] - sn.m_FailureTimestamps[j - 1];
+			}
+			failureMean /= sn.m_FailureTimestamps.size();
 		}
-		failureMean /= sn.m_FailureTimestamps.size();
 
 		SensorNodeData snData;
 		snData.SensorNodeID = sn.m_ID;
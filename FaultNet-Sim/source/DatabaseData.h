@@ -35,6 +35,7 @@ namespace FaultNet_Sim
         double TransmissionRange;
         double InterferenceRange;
         double TransferredTotalDuration;
+        int64_t ColorCount;
     };
 
     struct SensorNodeData
@@ -0,0 +1,130 @@
+#include "PCH.h"
+#include "DistanceKernels.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define FAULTNET_SIM_X64
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define FAULTNET_SIM_TARGET_AVX2
+	#else
+		#define FAULTNET_SIM_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace FaultNet_Sim
+{
+	std::string DistanceKernelTypeToString(const DistanceKernelType& dkt)
+	{
+		switch (dkt)
+		{
+		case DistanceKernelType::Scalar:
+			return "Scalar";
+		case DistanceKernelType::AVX2:
+			return "AVX2";
+		}
+
+		throw std::runtime_error("Unknown Distance Kernel Type in DistanceKernelTypeToString!");
+		return "";
+	}
+
+	static size_t DistancesWithinScalar(double x, double y, const double* xs, const double* ys, size_t count,
+		double minDistance, double maxDistance, int64_t* selected, double* distances)
+	{
+		size_t found = 0;
+		for (size_t k = 0; k < count; k++)
+		{
+			double distance = std::sqrt((x - xs[k]) * (x - xs[k]) + (y - ys[k]) * (y - ys[k]));
+			if (distance > minDistance && distance <= maxDistance)
+			{
+				selected[found] = (int64_t)k;
+				distances[found] = distance;
+				found++;
+			}
+		}
+		return found;
+	}
+
+#ifdef FAULTNET_SIM_X64
+	// Separate multiplies and adds, no FMA, so that every lane rounds like the scalar kernel.
+	static FAULTNET_SIM_TARGET_AVX2 size_t DistancesWithinAVX2(double x, double y, const double* xs, const double* ys, size_t count,
+		double minDistance, double maxDistance, int64_t* selected, double* distances)
+	{
+		__m256d pointX = _mm256_set1_pd(x);
+		__m256d pointY = _mm256_set1_pd(y);
+		__m256d lower = _mm256_set1_pd(minDistance);
+		__m256d upper = _mm256_set1_pd(maxDistance);
+
+		size_t found = 0;
+		size_t k = 0;
+		for (; k + 4 <= count; k += 4)
+		{
+			__m256d dx = _mm256_sub_pd(pointX, _mm256_loadu_pd(xs + k));
+			__m256d dy = _mm256_sub_pd(pointY, _mm256_loadu_pd(ys + k));
+			__m256d distance = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+
+			int mask = _mm256_movemask_pd(_mm256_and_pd(
+				_mm256_cmp_pd(distance, lower, _CMP_GT_OQ),
+				_mm256_cmp_pd(distance, upper, _CMP_LE_OQ)));
+			if (mask == 0)
+				continue;
+
+			alignas(32) double lanes[4];
+			_mm256_store_pd(lanes, distance);
+			for (int lane = 0; lane < 4; lane++)
+			{
+				if (mask & (1 << lane))
+				{
+					selected[found] = (int64_t)(k + lane);
+					distances[found] = lanes[lane];
+					found++;
+				}
+			}
+		}
+
+		size_t tail = DistancesWithinScalar(x, y, xs + k, ys + k, count - k, minDistance, maxDistance, selected + found, distances + found);
+		for (size_t t = found; t < found + tail; t++)
+			selected[t] += (int64_t)k;
+
+		return found + tail;
+	}
+#endif
+
+	static bool IsAVX2Supported()
+	{
+#if defined(FAULTNET_SIM_X64) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// AVX2 also needs the OS to save the YMM registers.
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#elif defined(FAULTNET_SIM_X64)
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+	}
+
+	DistanceKernelType GetDistanceKernelType()
+	{
+		static const DistanceKernelType s_Type = IsAVX2Supported() ? DistanceKernelType::AVX2 : DistanceKernelType::Scalar;
+		return s_Type;
+	}
+
+	size_t DistancesWithin(double x, double y, const double* xs, const double* ys, size_t count,
+		double minDistance, double maxDistance, int64_t* selected, double* distances)
+	{
+#ifdef FAULTNET_SIM_X64
+		if (GetDistanceKernelType() == DistanceKernelType::AVX2)
+			return DistancesWithinAVX2(x, y, xs, ys, count, minDistance, maxDistance, selected, distances);
+#endif
+		return DistancesWithinScalar(x, y, xs, ys, count, minDistance, maxDistance, selected, distances);
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace FaultNet_Sim
+{
+	enum class DistanceKernelType
+	{
+		Scalar = 0,
+		AVX2
+	};
+
+	std::string DistanceKernelTypeToString(const DistanceKernelType& dkt);
+
+	// The fastest kernel the CPU supports, detected on the first call.
+	DistanceKernelType GetDistanceKernelType();
+
+	// Computes the distance from (x, y) to each of the count points of xs and ys and keeps
+	// the ones with minDistance < distance <= maxDistance. Writes the positions of the kept
+	// points into selected and their distances into distances, both of which must hold count
+	// values, and returns how many were kept. The distances are bit-identical to
+	// SensorNode::Distance whichever kernel runs.
+	size_t DistancesWithin(double x, double y, const double* xs, const double* ys, size_t count,
+		double minDistance, double maxDistance, int64_t* selected, double* distances);
+}
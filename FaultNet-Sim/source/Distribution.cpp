@@ -7,32 +7,86 @@ namespace FaultNet_Sim
 {
 	std::mt19937_64 s_RNG(std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
-	static double FunctionWeibull(double xCurrent, double target)
+	// Digamma for x >= 1, shifted up with the recurrence and then expanded asymptotically.
+	static double Digamma(double x)
 	{
-		return std::tgammal(1 + 2 / xCurrent) / (std::tgammal(1 + 1 / xCurrent) * std::tgammal(1 + 1 / xCurrent)) - target;
+		double result = 0.0;
+		while (x < 6.0)
+		{
+			result -= 1.0 / x;
+			x += 1.0;
+		}
+
+		double inverse2 = 1.0 / (x * x);
+		return result + std::log(x) - 0.5 / x -
+			inverse2 * (1.0 / 12 - inverse2 * (1.0 / 120 - inverse2 * (1.0 / 252 - inverse2 * (1.0 / 240 - inverse2 / 132))));
 	}
-		
-	static double NewtonsMethodWeibull(double mean, double stddev)
+
+	// Weibull shape k with the coefficient of variation cv, the root of
+	// lgamma(1 + 2 / k) - 2 * lgamma(1 + 1 / k) - log(1 + cv^2), which decreases with k.
+	// Newton steps use the analytic derivative and fall back to bisection whenever
+	// they would leave the bracket around the root.
+	static double SolveWeibullShape(double cv)
 	{
-		static constexpr double x0 = 0.5;
-		static constexpr double step = 0.1;
-		static constexpr double maximumError = 0.00001;
+		double logTarget = std::log1p(cv * cv);
+		auto error = [&](double shape) { return std::lgamma(1 + 2 / shape) - 2 * std::lgamma(1 + 1 / shape) - logTarget; };
 
-		double target = (mean * mean + stddev * stddev) / (mean * mean);
+		double low = 1.0;
+		double high = 1.0;
+		while (error(low) < 0)
+		{
+			high = low;
+			low /= 2;
+		}
+		while (error(high) > 0)
+		{
+			low = high;
+			high *= 2;
+		}
 
-		double xCurrent = x0;
-		double yCurrent = FunctionWeibull(xCurrent, target);
-		double yCurrent2 = FunctionWeibull(xCurrent + step, target);
+		double shape = (low + high) / 2;
+		for (int iteration = 0; iteration < 100; iteration++)
+		{
+			double value = error(shape);
+			if (value == 0)
+				return shape;
+			if (value > 0)
+				low = shape;
+			else
+				high = shape;
+
+			double derivative = 2 / (shape * shape) * (Digamma(1 + 1 / shape) - Digamma(1 + 2 / shape));
+			double next = shape - value / derivative;
+			if (!(next > low && next < high))
+				next = (low + high) / 2;
+
+			if (std::abs(next - shape) <= 1e-15 * shape)
+				return next;
+			shape = next;
+		}
+
+		return shape;
+	}
+
+	// The shape only depends on the coefficient of variation, which the SNs of a deployment
+	// with different mean times between failures usually share, so each one is solved once.
+	static double WeibullShape(double cv)
+	{
+		static std::mutex s_Mutex;
+		static std::unordered_map<double, double> s_Shapes;
 
-		do
 		{
-			xCurrent -= yCurrent / ((yCurrent2 - yCurrent) / step);
-			yCurrent = FunctionWeibull(xCurrent, target);
-			yCurrent2 = FunctionWeibull(xCurrent + step, target);
+			std::lock_guard<std::mutex> lock(s_Mutex);
+			auto it = s_Shapes.find(cv);
+			if (it != s_Shapes.end())
+				return it->second;
+		}
 
-		} while (std::abs(yCurrent) > maximumError);
+		double shape = SolveWeibullShape(cv);
 
-		return xCurrent;
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		s_Shapes.emplace(cv, shape);
+		return shape;
 	}
 
 	ExponentialParameters::ExponentialParameters(double mean, double stddev)
@@ -54,7 +108,11 @@ namespace FaultNet_Sim
 
 	WeibullParameters::WeibullParameters(double mean, double stddev)
 	{
-		Shape = NewtonsMethodWeibull(mean, stddev);
+		double cv = stddev / mean;
+		if (!(mean > 0) || !(stddev > 0) || !std::isfinite(mean) || !std::isfinite(cv * cv))
+			throw std::runtime_error("Weibull distribution must have a finite positive mean and stddev!");
+
+		Shape = WeibullShape(cv);
 		Scale = mean / tgammal(1 + 1 / Shape);
 	}
 
@@ -84,139 +142,55 @@ namespace FaultNet_Sim
 
 		switch (distributionType)
 		{
-		case DistributionType::Exponential: 
-		{
-			if (mean != stddev)
-				throw std::runtime_error("Exponential distribution must have the same mean and stddev!");
-
-			ExponentialParameters params(mean, stddev);
-			m_Parameter1 = params.Rate;
-			m_Parameter2 = 0;
-			m_Distribution = new std::exponential_distribution<double>(params.Rate);
-			break;
-		}
-		case DistributionType::Gamma:
-		{
-			GammaParameters params(mean, stddev);
-			m_Parameter1 = params.Shape;
-			m_Parameter2 = params.Scale;
-			m_Distribution = new std::gamma_distribution<double>(params.Shape, params.Scale);
-			break;
-		}
-		case DistributionType::Lognormal:
-		{
-			LognormalParameters params(mean, stddev);
-			m_Parameter1 = params.M;
-			m_Parameter2 = params.S;
-			m_Distribution = new std::lognormal_distribution<double>(params.M, params.S);
-			break;
-		}
-		case DistributionType::Weibull:
-		{
-			WeibullParameters params(mean, stddev);
-			m_Parameter1 = params.Shape;
-			m_Parameter2 = params.Scale;
-			m_Distribution = new std::weibull_distribution<double>(params.Shape, params.Scale);
-			break;
-		}
-		case DistributionType::Normal:
-		{
-			NormalParameters params(mean, stddev);
-			m_Parameter1 = params.Mean;
-			m_Parameter2 = params.Stddev;
-			m_Distribution = new std::normal_distribution<double>(params.Mean, params.Stddev);
-			break;
-		}
-		case DistributionType::Uniform:
-		{
-			UniformParameters params(mean, stddev);
-			m_Parameter1 = params.A;
-			m_Parameter2 = params.B;
-			m_Distribution = new std::uniform_real_distribution<double>(params.A, params.B);
-			break;
-		}
-		default:
-		{
-			throw std::runtime_error("Unknown Distribution Type in Distribution Constructor");
-		}
-		}
-	}
-
-	Distribution::Distribution(const Distribution& other)
-		: Distribution(other.m_DistributionType, other.m_Mean, other.m_Stddev) {}
-
-	Distribution::~Distribution()
-	{
-		switch (m_DistributionType)
-		{
 		case DistributionType::Exponential:
-			delete (std::exponential_distribution<double>*)m_Distribution;
+			m_Distribution.emplace<TypedDistribution<DistributionType::Exponential>>(mean, stddev);
 			break;
 		case DistributionType::Gamma:
-			delete (std::gamma_distribution<double>*)m_Distribution;
+			m_Distribution.emplace<TypedDistribution<DistributionType::Gamma>>(mean, stddev);
 			break;
 		case DistributionType::Lognormal:
-			delete (std::lognormal_distribution<double>*)m_Distribution;
+			m_Distribution.emplace<TypedDistribution<DistributionType::Lognormal>>(mean, stddev);
 			break;
 		case DistributionType::Weibull:
-			delete (std::weibull_distribution<double>*)m_Distribution;
+			m_Distribution.emplace<TypedDistribution<DistributionType::Weibull>>(mean, stddev);
 			break;
 		case DistributionType::Normal:
-			delete (std::normal_distribution<double>*)m_Distribution;
+			m_Distribution.emplace<TypedDistribution<DistributionType::Normal>>(mean, stddev);
 			break;
 		case DistributionType::Uniform:
-			delete (std::uniform_real_distribution<double>*)m_Distribution;
+			m_Distribution.emplace<TypedDistribution<DistributionType::Uniform>>(mean, stddev);
 			break;
 		default:
 		{
-			throw std::runtime_error("Unknown Distribution Type in Distribution Destructor");
+			throw std::runtime_error("Unknown Distribution Type in Distribution Constructor");
 		}
 		}
 
+		std::visit([&](const auto& distribution)
+			{
+				m_Parameter1 = distribution.Parameter1();
+				m_Parameter2 = distribution.Parameter2();
+			}, m_Distribution);
 	}
 
 	double Distribution::GenerateRandomNumber()
 	{
-		switch (m_DistributionType)
-		{
-		case DistributionType::Exponential:
-			return (*(std::exponential_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Gamma:
-			return (*(std::gamma_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Lognormal:
-			return (*(std::lognormal_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Weibull:
-			return (*(std::weibull_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Normal:
-			return (*(std::normal_distribution<double>*)m_Distribution)(s_RNG);
-		case DistributionType::Uniform:
-			return (*(std::uniform_real_distribution<double>*)m_Distribution)(s_RNG);
-		}
-
-		throw std::runtime_error("Unknown Distribution Type in Distribution::GenerateRandomNumber");
-		return 0;
+		return GenerateRandomNumber(s_RNG);
 	}
 
 	double Distribution::GenerateRandomNumber(std::mt19937_64& rng)
 	{
-		switch (m_DistributionType)
-		{
-		case DistributionType::Exponential:
-			return (*(std::exponential_distribution<double>*)m_Distribution)(rng);
-		case DistributionType::Gamma:
-			return (*(std::gamma_distribution<double>*)m_Distribution)(rng);
-		case DistributionType::Lognormal:
-			return (*(std::lognormal_distribution<double>*)m_Distribution)(rng);
-		case DistributionType::Weibull:
-			return (*(std::weibull_distribution<double>*)m_Distribution)(rng);
-		case DistributionType::Normal:
-			return (*(std::normal_distribution<double>*)m_Distribution)(rng);
-		case DistributionType::Uniform:
-			return (*(std::uniform_real_distribution<double>*)m_Distribution)(rng);
-		}
+		return std::visit([&](auto& distribution) { return distribution(rng); }, m_Distribution);
+	}
 
-		throw std::runtime_error("Unknown Distribution Type in Distribution::GenerateRandomNumber");
-		return 0;
+	void Distribution::Fill(std::span<double> values)
+	{
+		Fill(values, s_RNG);
+	}
+
+	void Distribution::Fill(std::span<double> values, std::mt19937_64& rng)
+	{
+		std::visit([&](auto& distribution) { distribution.Fill(values, rng); }, m_Distribution);
 	}
 
 
@@ -16,28 +16,6 @@ namespace FaultNet_Sim
 
 	std::string DistributionTypeToString(const DistributionType& dt);
 
-	class Distribution
-	{
-	public:
-		Distribution();
-		Distribution(DistributionType distributionType, double mean, double stddev);
-		Distribution(const Distribution& other);
-		~Distribution();
-
-		double GenerateRandomNumber();
-		double GenerateRandomNumber(std::mt19937_64& rng);
-
-		void* m_Distribution;
-		DistributionType m_DistributionType;
-
-		double m_Mean;
-		double m_Stddev;
-
-		double m_Parameter1;
-		double m_Parameter2;
-
-	};
-
 	struct ExponentialParameters
 	{
 		ExponentialParameters(double mean, double stddev);
@@ -78,4 +56,195 @@ namespace FaultNet_Sim
 		double A; // a, lower limit
 		double B; // b, upper limit
 	};
-}
\ No newline at end of file
+
+	// The std distribution of a DistributionType, built from a mean and a stddev, and its two parameters.
+	template<DistributionType Type>
+	struct DistributionTraits;
+
+	template<>
+	struct DistributionTraits<DistributionType::Exponential>
+	{
+		using StdDistribution = std::exponential_distribution<double>;
+
+		static inline StdDistribution Create(double mean, double stddev)
+		{
+			if (mean != stddev)
+				throw std::runtime_error("Exponential distribution must have the same mean and stddev!");
+
+			ExponentialParameters params(mean, stddev);
+			return StdDistribution(params.Rate);
+		}
+
+		static inline double Parameter1(const StdDistribution& distribution) { return distribution.lambda(); }
+		static inline double Parameter2(const StdDistribution& distribution) { return 0; }
+	};
+
+	template<>
+	struct DistributionTraits<DistributionType::Gamma>
+	{
+		using StdDistribution = std::gamma_distribution<double>;
+
+		static inline StdDistribution Create(double mean, double stddev)
+		{
+			GammaParameters params(mean, stddev);
+			return StdDistribution(params.Shape, params.Scale);
+		}
+
+		static inline double Parameter1(const StdDistribution& distribution) { return distribution.alpha(); }
+		static inline double Parameter2(const StdDistribution& distribution) { return distribution.beta(); }
+	};
+
+	template<>
+	struct DistributionTraits<DistributionType::Lognormal>
+	{
+		using StdDistribution = std::lognormal_distribution<double>;
+
+		static inline StdDistribution Create(double mean, double stddev)
+		{
+			LognormalParameters params(mean, stddev);
+			return StdDistribution(params.M, params.S);
+		}
+
+		static inline double Parameter1(const StdDistribution& distribution) { return distribution.m(); }
+		static inline double Parameter2(const StdDistribution& distribution) { return distribution.s(); }
+	};
+
+	template<>
+	struct DistributionTraits<DistributionType::Weibull>
+	{
+		using StdDistribution = std::weibull_distribution<double>;
+
+		static inline StdDistribution Create(double mean, double stddev)
+		{
+			WeibullParameters params(mean, stddev);
+			return StdDistribution(params.Shape, params.Scale);
+		}
+
+		static inline double Parameter1(const StdDistribution& distribution) { return distribution.a(); }
+		static inline double Parameter2(const StdDistribution& distribution) { return distribution.b(); }
+	};
+
+	template<>
+	struct DistributionTraits<DistributionType::Normal>
+	{
+		using StdDistribution = std::normal_distribution<double>;
+
+		static inline StdDistribution Create(double mean, double stddev)
+		{
+			NormalParameters params(mean, stddev);
+			return StdDistribution(params.Mean, params.Stddev);
+		}
+
+		static inline double Parameter1(const StdDistribution& distribution) { return distribution.mean(); }
+		static inline double Parameter2(const StdDistribution& distribution) { return distribution.stddev(); }
+	};
+
+	template<>
+	struct DistributionTraits<DistributionType::Uniform>
+	{
+		using StdDistribution = std::uniform_real_distribution<double>;
+
+		static inline StdDistribution Create(double mean, double stddev)
+		{
+			UniformParameters params(mean, stddev);
+			return StdDistribution(params.A, params.B);
+		}
+
+		static inline double Parameter1(const StdDistribution& distribution) { return distribution.a(); }
+		static inline double Parameter2(const StdDistribution& distribution) { return distribution.b(); }
+	};
+
+	// Distribution whose type is known at compile time. It holds its std distribution by
+	// value and is trivially copyable, and draws from it are inlined into the caller.
+	template<DistributionType Type>
+	class TypedDistribution
+	{
+	public:
+		using StdDistribution = typename DistributionTraits<Type>::StdDistribution;
+
+		TypedDistribution() = default;
+		TypedDistribution(double mean, double stddev)
+			: m_Distribution(DistributionTraits<Type>::Create(mean, stddev)) {}
+
+		template<typename TRNG>
+		inline double operator()(TRNG& rng) { return m_Distribution(rng); }
+
+		template<typename TRNG>
+		inline void Fill(std::span<double> values, TRNG& rng)
+		{
+			for (double& value : values)
+				value = m_Distribution(rng);
+		}
+
+		// Draws from a fresh copy of the distribution, leaving this one untouched, so that
+		// any number of threads and engines can sample it at the same time.
+		template<typename TRNG>
+		inline double Sample(TRNG& rng) const
+		{
+			StdDistribution distribution(m_Distribution.param());
+			return distribution(rng);
+		}
+
+		template<typename TRNG>
+		inline void Sample(std::span<double> values, TRNG& rng) const
+		{
+			StdDistribution distribution(m_Distribution.param());
+			for (double& value : values)
+				value = distribution(rng);
+		}
+
+		inline double Parameter1() const { return DistributionTraits<Type>::Parameter1(m_Distribution); }
+		inline double Parameter2() const { return DistributionTraits<Type>::Parameter2(m_Distribution); }
+
+	private:
+		StdDistribution m_Distribution;
+	};
+
+	// Distribution whose type is chosen at runtime, one of the TypedDistributions held inline.
+	class Distribution
+	{
+	public:
+		Distribution();
+		Distribution(DistributionType distributionType, double mean, double stddev);
+
+		double GenerateRandomNumber();
+		double GenerateRandomNumber(std::mt19937_64& rng);
+
+		// Fills values with the draws GenerateRandomNumber would return one after another,
+		// dispatching on the type once for the whole span.
+		void Fill(std::span<double> values);
+		void Fill(std::span<double> values, std::mt19937_64& rng);
+
+		// Draws with rng from a copy of the distribution, leaving this one untouched,
+		// so that any number of threads and engines can sample it at the same time.
+		template<typename TRNG>
+		inline double Sample(TRNG& rng) const
+		{
+			return std::visit([&](const auto& distribution) { return distribution.Sample(rng); }, m_Distribution);
+		}
+
+		// Fills values like Sample, with one copy of the distribution for the whole span.
+		template<typename TRNG>
+		inline void Sample(std::span<double> values, TRNG& rng) const
+		{
+			std::visit([&](const auto& distribution) { distribution.Sample(values, rng); }, m_Distribution);
+		}
+
+		// Alternatives in the order of DistributionType.
+		std::variant<
+			TypedDistribution<DistributionType::Exponential>,
+			TypedDistribution<DistributionType::Gamma>,
+			TypedDistribution<DistributionType::Lognormal>,
+			TypedDistribution<DistributionType::Weibull>,
+			TypedDistribution<DistributionType::Normal>,
+			TypedDistribution<DistributionType::Uniform>
+		> m_Distribution;
+		DistributionType m_DistributionType = DistributionType::Exponential;
+
+		double m_Mean = 1.0;
+		double m_Stddev = 1.0;
+
+		double m_Parameter1 = 1.0;
+		double m_Parameter2 = 0.0;
+	};
+}
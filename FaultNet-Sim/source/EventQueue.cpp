@@ -0,0 +1,214 @@
+#include "PCH.h"
+#include "EventQueue.h"
+
+namespace FaultNet_Sim
+{
+	static constexpr int64_t s_MaxCalendarBucketCount = 1 << 20;
+
+	static bool EventFollows(const WorkingStateTimestamp& left, const WorkingStateTimestamp& right)
+	{
+		return EventPrecedes(right, left);
+	}
+
+	std::string EventQueueTypeToString(const EventQueueType& eqt)
+	{
+		switch (eqt)
+		{
+		case EventQueueType::BinaryHeap:
+			return "BinaryHeap";
+		case EventQueueType::CalendarQueue:
+			return "CalendarQueue";
+		case EventQueueType::Tournament:
+			return "Tournament";
+		}
+
+		throw std::runtime_error("Unknown Event Queue Type in EventQueueTypeToString!");
+		return "";
+	}
+
+	void BinaryHeapEventQueue::Push(const WorkingStateTimestamp& event)
+	{
+		m_Heap.push_back(event);
+		std::push_heap(m_Heap.begin(), m_Heap.end(), EventFollows);
+	}
+
+	void BinaryHeapEventQueue::Pop()
+	{
+		std::pop_heap(m_Heap.begin(), m_Heap.end(), EventFollows);
+		m_Heap.pop_back();
+	}
+
+	CalendarEventQueue::CalendarEventQueue(double bucketWidth, double horizon)
+		: m_BucketWidth(bucketWidth)
+	{
+		if (bucketWidth <= 0)
+			throw std::runtime_error("Calendar queue bucket width must be positive!");
+
+		int64_t requiredBucketCount = (int64_t)std::ceil(std::max(horizon, 0.0) / bucketWidth) + 2;
+		int64_t bucketCount = 1;
+		while (bucketCount < requiredBucketCount && bucketCount < s_MaxCalendarBucketCount)
+			bucketCount <<= 1;
+
+		m_Buckets.resize(bucketCount);
+		m_BucketMask = bucketCount - 1;
+	}
+
+	int64_t CalendarEventQueue::BucketIndex(double timestamp) const
+	{
+		return (int64_t)std::floor(timestamp / m_BucketWidth);
+	}
+
+	void CalendarEventQueue::Push(const WorkingStateTimestamp& event)
+	{
+		int64_t index = std::max(BucketIndex(event.Timestamp), m_CurrentBucket);
+		m_Size++;
+
+		if (index >= m_CurrentBucket + (int64_t)m_Buckets.size())
+		{
+			m_Overflow.Push(event);
+			return;
+		}
+
+		auto& bucket = m_Buckets[index & m_BucketMask];
+		if (index == m_CurrentBucket && m_CurrentSorted)
+			bucket.insert(std::lower_bound(bucket.begin(), bucket.end(), event, EventFollows), event);
+		else
+			bucket.push_back(event);
+	}
+
+	const WorkingStateTimestamp& CalendarEventQueue::Top()
+	{
+		Advance();
+		return m_Buckets[m_CurrentBucket & m_BucketMask].back();
+	}
+
+	void CalendarEventQueue::Pop()
+	{
+		Advance();
+		m_Buckets[m_CurrentBucket & m_BucketMask].pop_back();
+		m_Size--;
+	}
+
+	void CalendarEventQueue::Advance()
+	{
+		auto* bucket = &m_Buckets[m_CurrentBucket & m_BucketMask];
+
+		while (bucket->empty())
+		{
+			if (m_Size == m_Overflow.Size())
+				m_CurrentBucket = std::max(m_CurrentBucket + 1, BucketIndex(m_Overflow.Top().Timestamp));
+			else
+				m_CurrentBucket++;
+			m_CurrentSorted = false;
+
+			while (!m_Overflow.Empty() && BucketIndex(m_Overflow.Top().Timestamp) < m_CurrentBucket + (int64_t)m_Buckets.size())
+			{
+				WorkingStateTimestamp event = m_Overflow.Top();
+				m_Overflow.Pop();
+				m_Buckets[std::max(BucketIndex(event.Timestamp), m_CurrentBucket) & m_BucketMask].push_back(event);
+			}
+
+			bucket = &m_Buckets[m_CurrentBucket & m_BucketMask];
+		}
+
+		if (!m_CurrentSorted)
+		{
+			std::sort(bucket->begin(), bucket->end(), EventFollows);
+			m_CurrentSorted = true;
+		}
+	}
+
+	TournamentEventQueue::TournamentEventQueue(int64_t nodeCount)
+	{
+		m_LeafCount = 1;
+		while (m_LeafCount < nodeCount)
+			m_LeafCount <<= 1;
+
+		m_Leaves.resize(m_LeafCount);
+		for (int64_t i = 0; i < m_LeafCount; i++)
+			m_Leaves[i] = { i, WorkingState::Collection, std::numeric_limits<double>::infinity() };
+		m_Losers.resize(m_LeafCount);
+	}
+
+	bool TournamentEventQueue::Beats(int64_t left, int64_t right) const
+	{
+		return EventPrecedes(m_Leaves[left], m_Leaves[right]);
+	}
+
+	void TournamentEventQueue::Push(const WorkingStateTimestamp& event)
+	{
+		if (event.SNID < 0 || event.SNID >= m_LeafCount)
+			throw std::runtime_error("SNID out of range in TournamentEventQueue::Push");
+
+		m_Leaves[event.SNID] = event;
+		m_Size++;
+
+		if (!m_Dirty && event.SNID == m_PoppedSNID)
+			Replay(event.SNID);
+		else
+			m_Dirty = true;
+		m_PoppedSNID = -1;
+	}
+
+	void TournamentEventQueue::Pop()
+	{
+		int64_t leaf = Top().SNID;
+		m_Leaves[leaf].Timestamp = std::numeric_limits<double>::infinity();
+		m_Size--;
+
+		// The replay is deferred so that the usual pop-then-push of the same node costs a single pass.
+		m_PoppedSNID = leaf;
+	}
+
+	const WorkingStateTimestamp& TournamentEventQueue::Top()
+	{
+		if (m_Dirty)
+			Build();
+		else if (m_PoppedSNID != -1)
+		{
+			Replay(m_PoppedSNID);
+			m_PoppedSNID = -1;
+		}
+
+		return m_Leaves[m_Winner];
+	}
+
+	void TournamentEventQueue::Build()
+	{
+		std::vector<int64_t> winners(2 * m_LeafCount);
+		for (int64_t i = 0; i < m_LeafCount; i++)
+			winners[m_LeafCount + i] = i;
+
+		for (int64_t position = m_LeafCount - 1; position >= 1; position--)
+		{
+			int64_t left = winners[2 * position];
+			int64_t right = winners[2 * position + 1];
+			if (Beats(right, left))
+			{
+				winners[position] = right;
+				m_Losers[position] = left;
+			}
+			else
+			{
+				winners[position] = left;
+				m_Losers[position] = right;
+			}
+		}
+
+		m_Winner = winners[1];
+		m_Dirty = false;
+		m_PoppedSNID = -1;
+	}
+
+	void TournamentEventQueue::Replay(int64_t leaf)
+	{
+		int64_t winner = leaf;
+		for (int64_t position = (m_LeafCount + leaf) >> 1; position >= 1; position >>= 1)
+		{
+			if (Beats(m_Losers[position], winner))
+				std::swap(m_Losers[position], winner);
+		}
+
+		m_Winner = winner;
+	}
+}
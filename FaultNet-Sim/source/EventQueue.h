@@ -0,0 +1,107 @@
+#pragma once
+#include "SensorNode.h"
+
+namespace FaultNet_Sim
+{
+	enum class EventQueueType
+	{
+		BinaryHeap = 0,
+		CalendarQueue,
+		Tournament
+	};
+
+	std::string EventQueueTypeToString(const EventQueueType& eqt);
+
+	struct WorkingStateTimestamp
+	{
+		int64_t SNID;
+		WorkingState State;
+		double Timestamp;
+	};
+
+	// Earliest timestamp first, ties go to the larger SNID.
+	inline bool EventPrecedes(const WorkingStateTimestamp& left, const WorkingStateTimestamp& right)
+	{
+		if (left.Timestamp < right.Timestamp)
+			return true;
+		else if (left.Timestamp > right.Timestamp)
+			return false;
+
+		return left.SNID > right.SNID;
+	}
+
+	class BinaryHeapEventQueue
+	{
+	public:
+		void Push(const WorkingStateTimestamp& event);
+		void Pop();
+
+		inline const WorkingStateTimestamp& Top() { return m_Heap.front(); }
+		inline bool Empty() const { return m_Heap.empty(); }
+		inline size_t Size() const { return m_Heap.size(); }
+
+	private:
+		std::vector<WorkingStateTimestamp> m_Heap;
+	};
+
+	// Bucketed time wheel. Buckets are one TransferTime wide, so every slot-aligned
+	// event of a color lands in the same bucket; a bucket is only sorted once it
+	// becomes current. Events beyond the wheel horizon wait in an overflow heap.
+	class CalendarEventQueue
+	{
+	public:
+		CalendarEventQueue(double bucketWidth, double horizon);
+
+		void Push(const WorkingStateTimestamp& event);
+		void Pop();
+
+		const WorkingStateTimestamp& Top();
+		inline bool Empty() const { return m_Size == 0; }
+		inline size_t Size() const { return m_Size; }
+
+	private:
+		int64_t BucketIndex(double timestamp) const;
+		void Advance();
+
+		std::vector<std::vector<WorkingStateTimestamp>> m_Buckets;
+		int64_t m_BucketMask;
+		double m_BucketWidth;
+
+		int64_t m_CurrentBucket = 0;
+		bool m_CurrentSorted = false;
+		size_t m_Size = 0;
+
+		BinaryHeapEventQueue m_Overflow;
+	};
+
+	// Loser tree with one leaf per sensor node, for simulations where every node has
+	// exactly one pending event. Popping the winner and pushing that node's next event
+	// replays a single leaf-to-root path in place; pushing any other node (such as the
+	// initial events) only marks the tree for a rebuild on the next Top.
+	class TournamentEventQueue
+	{
+	public:
+		TournamentEventQueue(int64_t nodeCount);
+
+		void Push(const WorkingStateTimestamp& event);
+		void Pop();
+
+		const WorkingStateTimestamp& Top();
+		inline bool Empty() const { return m_Size == 0; }
+		inline size_t Size() const { return m_Size; }
+
+	private:
+		bool Beats(int64_t left, int64_t right) const;
+		void Build();
+		void Replay(int64_t leaf);
+
+		std::vector<WorkingStateTimestamp> m_Leaves;
+		std::vector<int64_t> m_Losers;
+		int64_t m_Winner = 0;
+		int64_t m_LeafCount;
+
+		int64_t m_PoppedSNID = -1;
+		bool m_Dirty = true;
+		size_t m_Size = 0;
+	};
+}
@@ -0,0 +1,38 @@
+#include "PCH.h"
+#include "FailureStream.h"
+
+namespace FaultNet_Sim
+{
+	FailureStream::FailureStream(const std::vector<double>& timestamps)
+		: m_Timestamps(timestamps.data()), m_End((int64_t)timestamps.size())
+	{
+		if (HasNext())
+			m_Next = m_Timestamps[0];
+	}
+
+	FailureStream::FailureStream(const Distribution& timeBetweenFailures, uint64_t randomKey)
+		: m_TimeBetweenFailures(&timeBetweenFailures), m_RNG(randomKey, RandomStream::Failures), m_End(std::numeric_limits<int64_t>::max())
+	{
+		m_Next = NextTimeBetweenFailures();
+	}
+
+	void FailureStream::Advance()
+	{
+		m_Index++;
+
+		if (m_TimeBetweenFailures)
+			m_Next += NextTimeBetweenFailures();
+		else if (HasNext())
+			m_Next = m_Timestamps[m_Index];
+	}
+
+	double FailureStream::NextTimeBetweenFailures()
+	{
+		if (m_BlockIterator == c_BlockSize)
+		{
+			m_TimeBetweenFailures->Sample(std::span<double>(m_Block), m_RNG);
+			m_BlockIterator = 0;
+		}
+		return m_Block[m_BlockIterator++];
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "Distribution.h"
+#include "CounterRNG.h"
+
+namespace FaultNet_Sim
+{
+	// Failure timestamps of one SN in increasing order. It either replays a list of
+	// timestamps, or draws the time between failures on demand from a distribution with
+	// the Failures stream of the SN's random key, in which case it never runs out, every
+	// copy of it produces the same failures, and its size does not depend on the simulated time.
+	class FailureStream
+	{
+	public:
+		FailureStream() = default;
+		// The list must outlive the stream.
+		FailureStream(const std::vector<double>& timestamps);
+		FailureStream(const Distribution& timeBetweenFailures, uint64_t randomKey);
+
+		inline bool HasNext() const { return m_Index < m_End; }
+		inline double Next() const { return m_Next; }
+		// Number of failures passed so far.
+		inline int64_t Index() const { return m_Index; }
+
+		void Advance();
+
+	private:
+		// Times between failures are drawn this many at a time.
+		static constexpr int c_BlockSize = 8;
+
+		double NextTimeBetweenFailures();
+
+		const double* m_Timestamps = nullptr;
+		const Distribution* m_TimeBetweenFailures = nullptr;
+		CounterRNG m_RNG;
+		double m_Block[c_BlockSize] = {};
+		int m_BlockIterator = c_BlockSize;
+
+		double m_Next = 0.0;
+		int64_t m_Index = 0;
+		int64_t m_End = 0;
+	};
+}
@@ -0,0 +1,328 @@
+#include "PCH.h"
+#include "GraphColoring.h"
+
+namespace FaultNet_Sim
+{
+	std::string ColoringTypeToString(const ColoringType& ct)
+	{
+		switch (ct)
+		{
+		case ColoringType::WelshPowell:
+			return "WelshPowell";
+		case ColoringType::DSatur:
+			return "DSatur";
+		case ColoringType::SmallestLast:
+			return "SmallestLast";
+		case ColoringType::JonesPlassmann:
+			return "JonesPlassmann";
+		}
+
+		throw std::runtime_error("Unknown Coloring Type in ColoringTypeToString!");
+		return "";
+	}
+
+	// Gives sn the smallest color none of its colored neighbors has, usedBy[c] == sn
+	// marks the colors taken around sn.
+	static inline void ColorFirstFit(const InterferenceGraph& graph, int64_t sn, std::vector<int64_t>& colors, std::vector<int64_t>& usedBy)
+	{
+		for (const int64_t* neighbor = graph.NeighborsBegin(sn); neighbor != graph.NeighborsEnd(sn); neighbor++)
+		{
+			int64_t color = colors[*neighbor];
+			if (color < 0)
+				continue;
+
+			if (color >= usedBy.size())
+				usedBy.resize(color + 1, -1);
+			usedBy[color] = sn;
+		}
+
+		int64_t color = 0;
+		while (color < usedBy.size() && usedBy[color] == sn)
+			color++;
+
+		colors[sn] = color;
+	}
+
+	static std::vector<int64_t> IncludedDegrees(const InterferenceGraph& graph, const std::vector<char>& include)
+	{
+		std::vector<int64_t> degree(graph.Size(), 0);
+
+		for (int64_t sn = 0; sn < graph.Size(); sn++)
+		{
+			if (!include[sn])
+				continue;
+
+			for (const int64_t* neighbor = graph.NeighborsBegin(sn); neighbor != graph.NeighborsEnd(sn); neighbor++)
+			{
+				if (include[*neighbor])
+					degree[sn]++;
+			}
+		}
+
+		return degree;
+	}
+
+	// Largest degree first. Taking the colors one after another and giving each to every
+	// SN in this order that has no neighbor of that color yet colors exactly like first fit.
+	static std::vector<int64_t> WelshPowellOrder(const InterferenceGraph& graph, const std::vector<char>& include)
+	{
+		std::vector<int64_t> degree = IncludedDegrees(graph, include);
+		std::vector<int64_t> order;
+
+		for (int64_t sn = 0; sn < graph.Size(); sn++)
+		{
+			if (include[sn])
+				order.push_back(sn);
+		}
+
+		std::sort(order.begin(), order.end(), [&](int64_t sn1, int64_t sn2) {
+			return degree[sn1] > degree[sn2];
+			});
+
+		return order;
+	}
+
+	// Repeatedly removes an SN of smallest remaining degree and colors in the reverse
+	// order of removal, so every SN has at most the degeneracy of the graph colored
+	// neighbors when it is colored.
+	static std::vector<int64_t> SmallestLastOrder(const InterferenceGraph& graph, const std::vector<char>& include)
+	{
+		std::vector<int64_t> degree = IncludedDegrees(graph, include);
+
+		int64_t maxDegree = 0;
+		for (int64_t sn = 0; sn < graph.Size(); sn++)
+		{
+			if (include[sn])
+				maxDegree = std::max(maxDegree, degree[sn]);
+		}
+
+		// Buckets of SNs by remaining degree as doubly linked lists.
+		std::vector<int64_t> head(maxDegree + 1, -1);
+		std::vector<int64_t> next(graph.Size(), -1);
+		std::vector<int64_t> previous(graph.Size(), -1);
+		std::vector<char> removed(graph.Size(), false);
+
+		auto unlink = [&](int64_t sn)
+			{
+				if (previous[sn] >= 0)
+					next[previous[sn]] = next[sn];
+				else
+					head[degree[sn]] = next[sn];
+				if (next[sn] >= 0)
+					previous[next[sn]] = previous[sn];
+			};
+
+		auto link = [&](int64_t sn)
+			{
+				previous[sn] = -1;
+				next[sn] = head[degree[sn]];
+				if (next[sn] >= 0)
+					previous[next[sn]] = sn;
+				head[degree[sn]] = sn;
+			};
+
+		int64_t remaining = 0;
+		for (int64_t sn = graph.Size() - 1; sn >= 0; sn--)
+		{
+			if (!include[sn])
+				continue;
+
+			link(sn);
+			remaining++;
+		}
+
+		std::vector<int64_t> order(remaining);
+		int64_t lowest = 0;
+
+		while (remaining > 0)
+		{
+			while (head[lowest] < 0)
+				lowest++;
+
+			int64_t sn = head[lowest];
+			unlink(sn);
+			removed[sn] = true;
+			order[--remaining] = sn;
+
+			for (const int64_t* neighbor = graph.NeighborsBegin(sn); neighbor != graph.NeighborsEnd(sn); neighbor++)
+			{
+				if (!include[*neighbor] || removed[*neighbor])
+					continue;
+
+				unlink(*neighbor);
+				degree[*neighbor]--;
+				link(*neighbor);
+			}
+
+			lowest = std::max<int64_t>(lowest - 1, 0);
+		}
+
+		return order;
+	}
+
+	// Colors next the SN with the most distinct colors among its neighbors, ties going
+	// to the larger degree and then to the lower index.
+	static void ColorDSatur(const InterferenceGraph& graph, const std::vector<char>& include, std::vector<int64_t>& colors)
+	{
+		std::vector<int64_t> degree = IncludedDegrees(graph, include);
+		std::vector<int64_t> saturation(graph.Size(), 0);
+		std::vector<std::vector<char>> neighborColors(graph.Size());
+		std::vector<int64_t> usedBy;
+
+		std::set<std::tuple<int64_t, int64_t, int64_t>> candidates;
+		for (int64_t sn = 0; sn < graph.Size(); sn++)
+		{
+			if (include[sn])
+				candidates.insert({ 0, -degree[sn], sn });
+		}
+
+		while (!candidates.empty())
+		{
+			int64_t sn = std::get<2>(*candidates.begin());
+			candidates.erase(candidates.begin());
+
+			ColorFirstFit(graph, sn, colors, usedBy);
+			int64_t color = colors[sn];
+
+			for (const int64_t* neighbor = graph.NeighborsBegin(sn); neighbor != graph.NeighborsEnd(sn); neighbor++)
+			{
+				if (!include[*neighbor] || colors[*neighbor] >= 0)
+					continue;
+
+				std::vector<char>& seen = neighborColors[*neighbor];
+				if (color >= seen.size())
+					seen.resize(color + 1, false);
+				if (seen[color])
+					continue;
+				seen[color] = true;
+
+				candidates.erase({ -saturation[*neighbor], -degree[*neighbor], *neighbor });
+				saturation[*neighbor]++;
+				candidates.insert({ -saturation[*neighbor], -degree[*neighbor], *neighbor });
+			}
+
+			std::vector<char>().swap(neighborColors[sn]);
+		}
+	}
+
+	// SplitMix64, a priority only depends on the seed and the SN.
+	static inline uint64_t Priority(uint64_t seed, int64_t sn)
+	{
+		uint64_t z = seed + (uint64_t)(sn + 1) * 0x9E3779B97F4A7C15ull;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// In every round, the uncolored SNs whose neighbors of higher priority are all colored
+	// form an independent set and take the smallest color their neighbors do not have.
+	// Every SN is colored after its neighbors of higher priority and before the others,
+	// so the colors are those of first fit in priority order, whatever the number of threads.
+	static void ColorJonesPlassmann(const InterferenceGraph& graph, const std::vector<char>& include, std::vector<int64_t>& colors, size_t threadCount, uint64_t seed)
+	{
+		std::vector<uint64_t> priority(graph.Size());
+		for (int64_t sn = 0; sn < graph.Size(); sn++)
+			priority[sn] = Priority(seed, sn);
+
+		auto precedes = [&](int64_t a, int64_t b) { return priority[a] > priority[b] || (priority[a] == priority[b] && a < b); };
+
+		// Uncolored neighbors of higher priority of every SN, an SN joins the next round when it reaches 0.
+		std::vector<std::atomic<int64_t>> waiting(graph.Size());
+		std::vector<int64_t> round;
+		for (int64_t sn = 0; sn < graph.Size(); sn++)
+		{
+			if (!include[sn])
+				continue;
+
+			int64_t count = 0;
+			for (const int64_t* neighbor = graph.NeighborsBegin(sn); neighbor != graph.NeighborsEnd(sn); neighbor++)
+			{
+				if (include[*neighbor] && precedes(*neighbor, sn))
+					count++;
+			}
+
+			waiting[sn].store(count, std::memory_order_relaxed);
+			if (count == 0)
+				round.push_back(sn);
+		}
+
+		if (threadCount == 0)
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		threadCount = std::min(threadCount, std::max<size_t>(1, round.size()));
+
+		std::vector<std::vector<int64_t>> nextRound(threadCount);
+
+		auto completeRound = [&]() noexcept
+		{
+			round.clear();
+			for (std::vector<int64_t>& next : nextRound)
+			{
+				round.insert(round.end(), next.begin(), next.end());
+				next.clear();
+			}
+		};
+
+		std::barrier barrier(threadCount, completeRound);
+
+		auto work = [&](size_t worker)
+		{
+			std::vector<int64_t> usedBy;
+
+			while (!round.empty())
+			{
+				size_t begin = round.size() * worker / threadCount;
+				size_t end = round.size() * (worker + 1) / threadCount;
+
+				for (size_t i = begin; i < end; i++)
+				{
+					int64_t sn = round[i];
+					ColorFirstFit(graph, sn, colors, usedBy);
+
+					for (const int64_t* neighbor = graph.NeighborsBegin(sn); neighbor != graph.NeighborsEnd(sn); neighbor++)
+					{
+						if (include[*neighbor] && precedes(sn, *neighbor) && waiting[*neighbor].fetch_sub(1, std::memory_order_relaxed) == 1)
+							nextRound[worker].push_back(*neighbor);
+					}
+				}
+
+				barrier.arrive_and_wait();
+			}
+		};
+
+		std::vector<std::thread> workers;
+		for (size_t i = 1; i < threadCount; i++)
+			workers.emplace_back(work, i);
+		work(0);
+
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	std::vector<int64_t> ColorGraph(const InterferenceGraph& graph, const std::vector<char>& include, ColoringType type, size_t threadCount, uint64_t seed)
+	{
+		std::vector<int64_t> colors(graph.Size(), -1);
+		std::vector<int64_t> usedBy;
+
+		switch (type)
+		{
+		case ColoringType::WelshPowell:
+			for (int64_t sn : WelshPowellOrder(graph, include))
+				ColorFirstFit(graph, sn, colors, usedBy);
+			break;
+		case ColoringType::DSatur:
+			ColorDSatur(graph, include, colors);
+			break;
+		case ColoringType::SmallestLast:
+			for (int64_t sn : SmallestLastOrder(graph, include))
+				ColorFirstFit(graph, sn, colors, usedBy);
+			break;
+		case ColoringType::JonesPlassmann:
+			ColorJonesPlassmann(graph, include, colors, threadCount, seed);
+			break;
+		default:
+			throw std::runtime_error("Unknown Coloring Type in ColorGraph!");
+		}
+
+		return colors;
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "InterferenceGraph.h"
+
+namespace FaultNet_Sim
+{
+	enum class ColoringType
+	{
+		WelshPowell = 0,
+		DSatur,
+		SmallestLast,
+		JonesPlassmann
+	};
+
+	std::string ColoringTypeToString(const ColoringType& ct);
+
+	// Colors the SNs of the graph for which include is set so that no two neighbors share
+	// a color, using the smallest colors possible in the order chosen by the algorithm.
+	// SNs that are not included are left at -1 and do not constrain their neighbors.
+	// JonesPlassmann runs on threadCount threads, 0 uses one per hardware thread, and
+	// orders the SNs by random priorities drawn from seed, so that its colors only
+	// depend on the seed.
+	std::vector<int64_t> ColorGraph(const InterferenceGraph& graph, const std::vector<char>& include, ColoringType type, size_t threadCount = 1, uint64_t seed = 0);
+}
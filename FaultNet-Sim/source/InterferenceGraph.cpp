@@ -0,0 +1,28 @@
+#include "PCH.h"
+#include "InterferenceGraph.h"
+
+namespace FaultNet_Sim
+{
+	void InterferenceGraph::Build(const NeighborList& neighbors, double interferenceRange)
+	{
+		m_Offsets.assign(1, 0);
+		m_Neighbors.clear();
+
+		for (int64_t i = 0; i < neighbors.Size(); i++)
+		{
+			size_t begin = m_Neighbors.size();
+
+			for (int64_t k = neighbors.Begin(i); k < neighbors.EndWithin(i, interferenceRange); k++)
+				m_Neighbors.push_back(neighbors.Neighbor(k));
+
+			std::sort(m_Neighbors.begin() + begin, m_Neighbors.end());
+			m_Offsets.push_back((int64_t)m_Neighbors.size());
+		}
+	}
+
+	void InterferenceGraph::Clear()
+	{
+		m_Offsets.clear();
+		m_Neighbors.clear();
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "NeighborList.h"
+
+namespace FaultNet_Sim
+{
+	// SNs within InterferenceRange of each other, in compressed sparse row form. The
+	// neighbors of an SN exclude the SN itself and are sorted by index.
+	class InterferenceGraph
+	{
+	public:
+		void Build(const NeighborList& neighbors, double interferenceRange);
+		void Clear();
+
+		inline size_t Size() const { return m_Offsets.empty() ? 0 : m_Offsets.size() - 1; }
+		inline int64_t Degree(int64_t sn) const { return m_Offsets[sn + 1] - m_Offsets[sn]; }
+
+		inline const int64_t* NeighborsBegin(int64_t sn) const { return m_Neighbors.data() + m_Offsets[sn]; }
+		inline const int64_t* NeighborsEnd(int64_t sn) const { return m_Neighbors.data() + m_Offsets[sn + 1]; }
+
+	private:
+		std::vector<int64_t> m_Offsets;
+		std::vector<int64_t> m_Neighbors;
+	};
+}
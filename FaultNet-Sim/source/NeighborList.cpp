@@ -0,0 +1,60 @@
+#include "PCH.h"
+#include "NeighborList.h"
+#include "DistanceKernels.h"
+
+namespace FaultNet_Sim
+{
+	NeighborList::NeighborList(const SpatialIndex& index, double range, const NeighborList* previous)
+		: m_Range(range)
+	{
+		struct IDDistance
+		{
+			int64_t SNID;
+			double Distance;
+		};
+
+		std::vector<IDDistance> added;
+
+		// Large enough for any row of candidates.
+		std::vector<int64_t> selected(index.Size());
+		std::vector<double> distances(index.Size());
+		double lowerRange = previous != nullptr ? previous->m_Range : -std::numeric_limits<double>::infinity();
+
+		m_Offsets.reserve(index.Size() + 1);
+		m_Offsets.push_back(0);
+
+		for (int64_t i = 0; i < index.Size(); i++)
+		{
+			if (previous != nullptr)
+			{
+				m_Neighbors.insert(m_Neighbors.end(), previous->m_Neighbors.begin() + previous->Begin(i), previous->m_Neighbors.begin() + previous->End(i));
+				m_Distances.insert(m_Distances.end(), previous->m_Distances.begin() + previous->Begin(i), previous->m_Distances.begin() + previous->End(i));
+			}
+
+			// Everything beyond the previous range comes after the previous row.
+			added.clear();
+			index.ForEachCandidateRun(index.X(i), index.Y(i), range, [&](const int64_t* SNs, const double* xs, const double* ys, size_t count)
+				{
+					size_t found = DistancesWithin(index.X(i), index.Y(i), xs, ys, count, lowerRange, range, selected.data(), distances.data());
+					for (size_t k = 0; k < found; k++)
+					{
+						if (SNs[selected[k]] != i)
+							added.push_back({ SNs[selected[k]], distances[k] });
+					}
+				});
+
+			std::sort(added.begin(), added.end(), [](const IDDistance& a, const IDDistance& b)
+				{
+					return a.Distance < b.Distance || (a.Distance == b.Distance && a.SNID < b.SNID);
+				});
+
+			for (const IDDistance& neighbor : added)
+			{
+				m_Neighbors.push_back(neighbor.SNID);
+				m_Distances.push_back(neighbor.Distance);
+			}
+
+			m_Offsets.push_back((int64_t)m_Neighbors.size());
+		}
+	}
+}
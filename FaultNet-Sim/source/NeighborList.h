@@ -0,0 +1,40 @@
+#pragma once
+#include "SpatialIndex.h"
+
+namespace FaultNet_Sim
+{
+	// Neighbors of every SN up to a range, sorted by distance and then by index, so that
+	// the neighbors within any smaller range are a prefix of each row. A list for a larger
+	// range is built from a smaller one by adding the pairs between the two ranges only.
+	class NeighborList
+	{
+	public:
+		NeighborList(const SpatialIndex& index, double range, const NeighborList* previous = nullptr);
+
+		inline double Range() const { return m_Range; }
+		inline size_t Size() const { return m_Offsets.size() - 1; }
+
+		inline int64_t Begin(int64_t sn) const { return m_Offsets[sn]; }
+		inline int64_t End(int64_t sn) const { return m_Offsets[sn + 1]; }
+
+		// End of the neighbors at a distance of at most range, and below range.
+		inline int64_t EndWithin(int64_t sn, double range) const
+		{
+			return std::upper_bound(m_Distances.begin() + m_Offsets[sn], m_Distances.begin() + m_Offsets[sn + 1], range) - m_Distances.begin();
+		}
+		inline int64_t EndBelow(int64_t sn, double range) const
+		{
+			return std::lower_bound(m_Distances.begin() + m_Offsets[sn], m_Distances.begin() + m_Offsets[sn + 1], range) - m_Distances.begin();
+		}
+
+		inline int64_t Neighbor(int64_t k) const { return m_Neighbors[k]; }
+		inline double Distance(int64_t k) const { return m_Distances[k]; }
+
+	private:
+		double m_Range;
+
+		std::vector<int64_t> m_Offsets;
+		std::vector<int64_t> m_Neighbors;
+		std::vector<double> m_Distances;
+	};
+}
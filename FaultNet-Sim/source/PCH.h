@@ -2,6 +2,7 @@
 
 #include <random>
 #include <vector>
+#include <span>
 #include <chrono>
 #include <iostream>
 #include <cmath>
@@ -10,6 +11,13 @@
 #include <filesystem>
 #include <stdexcept>
 #include <map>
+#include <set>
+#include <tuple>
+#include <variant>
+#include <typeindex>
+#include <functional>
+#include <mutex>
+#include <future>
 #include <unordered_map>
 #include <memory>
 #include <sstream>
@@ -18,5 +26,7 @@
 #include <algorithm>
 #include <semaphore>
 #include <thread>
+#include <barrier>
+#include <atomic>
 #include <condition_variable>
 #include <cstring>
\ No newline at end of file
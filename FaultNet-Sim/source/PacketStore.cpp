@@ -0,0 +1,228 @@
+#include "PCH.h"
+#include "PacketStore.h"
+
+namespace FaultNet_Sim
+{
+	// Scratch space for AggregatedPacketStore::Forward, one per thread since partitions of a run may forward concurrently.
+	static thread_local std::vector<PacketBatch> s_MergeBuffer;
+
+	std::string PacketAccountingTypeToString(const PacketAccountingType& pat)
+	{
+		switch (pat)
+		{
+		case PacketAccountingType::Exact:
+			return "Exact";
+		case PacketAccountingType::Aggregated:
+			return "Aggregated";
+		case PacketAccountingType::Pooled:
+			return "Pooled";
+		}
+
+		throw std::runtime_error("Unknown Packet Accounting Type in PacketAccountingTypeToString!");
+		return "";
+	}
+
+	void ExactPacketStore::Open(int64_t sn, double timestamp, double bitRate)
+	{
+		m_Table.m_Packets[sn].push_back({ sn, timestamp });
+		m_Table.m_CurrentPacketIterator[sn] = m_Table.m_Packets[sn].size() - 1;
+	}
+
+	void ExactPacketStore::Close(int64_t sn, double timestamp, double bitRate)
+	{
+		Packet& packet = m_Table.m_Packets[sn][m_Table.m_CurrentPacketIterator[sn]];
+		packet.Size = (timestamp - packet.InitialTimestamp) * bitRate;
+	}
+
+	void ExactPacketStore::Forward(int64_t sn, int64_t destination)
+	{
+		std::vector<Packet>& packets = m_Table.m_Packets[sn];
+		std::vector<Packet>& destinationPackets = m_Table.m_Packets[destination];
+		destinationPackets.insert(destinationPackets.end(), packets.begin(), packets.end());
+	}
+
+	void ExactPacketStore::Clear(int64_t sn)
+	{
+		m_Table.m_Packets[sn].clear();
+		m_Table.m_CurrentPacketIterator[sn] = -1;
+	}
+
+	void ExactPacketStore::Shift(int64_t sn, double offset)
+	{
+		for (Packet& packet : m_Table.m_Packets[sn])
+			packet.InitialTimestamp += offset;
+	}
+
+	void ExactPacketStore::Receive(int64_t sn, const PacketBatch& batch)
+	{
+		m_Table.m_Packets[sn].push_back({ batch.InitialSNID, batch.InitialTimestampSum, batch.SizeSum });
+	}
+
+	AggregatedPacketStore::AggregatedPacketStore(size_t nodeCount)
+		: m_Batches(nodeCount), m_OpenTimestamps(nodeCount, 0.0) {}
+
+	void AggregatedPacketStore::Open(int64_t sn, double timestamp, double bitRate)
+	{
+		m_OpenTimestamps[sn] = timestamp;
+	}
+
+	void AggregatedPacketStore::Close(int64_t sn, double timestamp, double bitRate)
+	{
+		std::vector<PacketBatch>& batches = m_Batches[sn];
+		auto it = std::lower_bound(batches.begin(), batches.end(), sn,
+			[](const PacketBatch& batch, int64_t snid) { return batch.InitialSNID < snid; });
+		if (it == batches.end() || it->InitialSNID != sn)
+			it = batches.insert(it, { sn, 0, 0.0, 0.0 });
+
+		it->Count++;
+		it->InitialTimestampSum += m_OpenTimestamps[sn];
+		it->SizeSum += (timestamp - m_OpenTimestamps[sn]) * bitRate;
+	}
+
+	void AggregatedPacketStore::Forward(int64_t sn, int64_t destination)
+	{
+		const std::vector<PacketBatch>& batches = m_Batches[sn];
+		std::vector<PacketBatch>& destinationBatches = m_Batches[destination];
+
+		s_MergeBuffer.clear();
+		s_MergeBuffer.reserve(batches.size() + destinationBatches.size());
+
+		int i = 0;
+		int j = 0;
+		while (i < batches.size() || j < destinationBatches.size())
+		{
+			if (j == destinationBatches.size() || (i < batches.size() && batches[i].InitialSNID < destinationBatches[j].InitialSNID))
+				s_MergeBuffer.push_back(batches[i++]);
+			else if (i == batches.size() || destinationBatches[j].InitialSNID < batches[i].InitialSNID)
+				s_MergeBuffer.push_back(destinationBatches[j++]);
+			else
+			{
+				PacketBatch batch = destinationBatches[j++];
+				batch.Count += batches[i].Count;
+				batch.InitialTimestampSum += batches[i].InitialTimestampSum;
+				batch.SizeSum += batches[i].SizeSum;
+				s_MergeBuffer.push_back(batch);
+				i++;
+			}
+		}
+
+		destinationBatches.swap(s_MergeBuffer);
+	}
+
+	void AggregatedPacketStore::Clear(int64_t sn)
+	{
+		m_Batches[sn].clear();
+	}
+
+	void AggregatedPacketStore::Shift(int64_t sn, double offset)
+	{
+		for (PacketBatch& batch : m_Batches[sn])
+			batch.InitialTimestampSum += batch.Count * offset;
+		m_OpenTimestamps[sn] += offset;
+	}
+
+	void AggregatedPacketStore::Receive(int64_t sn, const PacketBatch& batch)
+	{
+		std::vector<PacketBatch>& batches = m_Batches[sn];
+		auto it = std::lower_bound(batches.begin(), batches.end(), batch.InitialSNID,
+			[](const PacketBatch& b, int64_t snid) { return b.InitialSNID < snid; });
+		if (it == batches.end() || it->InitialSNID != batch.InitialSNID)
+		{
+			batches.insert(it, batch);
+			return;
+		}
+
+		it->Count += batch.Count;
+		it->InitialTimestampSum += batch.InitialTimestampSum;
+		it->SizeSum += batch.SizeSum;
+	}
+
+	PooledPacketStore::PooledPacketStore(size_t nodeCount)
+		: m_Head(nodeCount, c_NullLink), m_Tail(nodeCount, c_NullLink), m_OpenPacket(nodeCount, c_NullLink)
+	{
+		m_Pool.reserve(nodeCount * 4);
+	}
+
+	int64_t PooledPacketStore::Allocate(const Packet& packet)
+	{
+		int64_t link = m_FreeHead;
+		if (link != c_NullLink)
+		{
+			m_FreeHead = m_Pool[link].Next;
+			m_Pool[link] = { packet, c_NullLink };
+		}
+		else
+		{
+			link = m_Pool.size();
+			m_Pool.push_back({ packet, c_NullLink });
+		}
+
+		return link;
+	}
+
+	void PooledPacketStore::Open(int64_t sn, double timestamp, double bitRate)
+	{
+		int64_t link = Allocate({ sn, timestamp });
+
+		if (m_Head[sn] == c_NullLink)
+			m_Head[sn] = link;
+		else
+			m_Pool[m_Tail[sn]].Next = link;
+
+		m_Tail[sn] = link;
+		m_OpenPacket[sn] = link;
+	}
+
+	void PooledPacketStore::Close(int64_t sn, double timestamp, double bitRate)
+	{
+		Packet& packet = m_Pool[m_OpenPacket[sn]].Value;
+		packet.Size = (timestamp - packet.InitialTimestamp) * bitRate;
+	}
+
+	void PooledPacketStore::Forward(int64_t sn, int64_t destination)
+	{
+		if (m_Head[sn] == c_NullLink)
+			return;
+
+		if (m_Head[destination] == c_NullLink)
+			m_Head[destination] = m_Head[sn];
+		else
+			m_Pool[m_Tail[destination]].Next = m_Head[sn];
+
+		m_Tail[destination] = m_Tail[sn];
+		m_Head[sn] = c_NullLink;
+		m_Tail[sn] = c_NullLink;
+		m_OpenPacket[sn] = c_NullLink;
+	}
+
+	void PooledPacketStore::Clear(int64_t sn)
+	{
+		if (m_Head[sn] != c_NullLink)
+		{
+			m_Pool[m_Tail[sn]].Next = m_FreeHead;
+			m_FreeHead = m_Head[sn];
+		}
+
+		m_Head[sn] = c_NullLink;
+		m_Tail[sn] = c_NullLink;
+		m_OpenPacket[sn] = c_NullLink;
+	}
+
+	void PooledPacketStore::Shift(int64_t sn, double offset)
+	{
+		for (int64_t link = m_Head[sn]; link != c_NullLink; link = m_Pool[link].Next)
+			m_Pool[link].Value.InitialTimestamp += offset;
+	}
+
+	void PooledPacketStore::Receive(int64_t sn, const PacketBatch& batch)
+	{
+		int64_t link = Allocate({ batch.InitialSNID, batch.InitialTimestampSum, batch.SizeSum });
+
+		if (m_Head[sn] == c_NullLink)
+			m_Head[sn] = link;
+		else
+			m_Pool[m_Tail[sn]].Next = link;
+
+		m_Tail[sn] = link;
+	}
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include "SensorNodeTable.h"
+
+namespace FaultNet_Sim
+{
+	enum class PacketAccountingType
+	{
+		Exact = 0,
+		Aggregated,
+		Pooled
+	};
+
+	std::string PacketAccountingTypeToString(const PacketAccountingType& pat);
+
+	// Packets of one origin SN seen as a whole. A single packet is a batch with Count 1.
+	struct PacketBatch
+	{
+		int64_t InitialSNID;
+		int64_t Count;
+		double InitialTimestampSum;
+		double SizeSum;
+	};
+
+	// Packet stores hold the packets buffered at each SN during Simulate.
+	// Open starts the SN's own packet, Close sizes it when the transfer starts,
+	// Forward hands every buffered packet to another SN and ForEachBatch visits
+	// them for delivery and loss accounting. Shift moves the packets of an SN in
+	// time when the simulation skips ahead, and Receive appends a batch handed
+	// over by another part of a partitioned simulation.
+
+	// One Packet per collection cycle, kept in the SN table.
+	class ExactPacketStore
+	{
+	public:
+		ExactPacketStore(SensorNodeTable& snt)
+			: m_Table(snt) {}
+
+		void Open(int64_t sn, double timestamp, double bitRate);
+		void Close(int64_t sn, double timestamp, double bitRate);
+		void Forward(int64_t sn, int64_t destination);
+		void Clear(int64_t sn);
+		void Shift(int64_t sn, double offset);
+		void Receive(int64_t sn, const PacketBatch& batch);
+
+		template<typename TFunction>
+		inline void ForEachBatch(int64_t sn, TFunction function) const
+		{
+			for (const Packet& packet : m_Table.m_Packets[sn])
+				function(PacketBatch{ packet.InitialSNID, 1, packet.InitialTimestamp, packet.Size });
+		}
+
+	private:
+		SensorNodeTable& m_Table;
+	};
+
+	// One PacketBatch per origin SN, sorted by origin, so forwarding, delivery and
+	// loss accounting cost O(origins) instead of O(packets). The open packet of an
+	// SN only joins its batch once it is closed.
+	class AggregatedPacketStore
+	{
+	public:
+		AggregatedPacketStore(size_t nodeCount);
+
+		void Open(int64_t sn, double timestamp, double bitRate);
+		void Close(int64_t sn, double timestamp, double bitRate);
+		void Forward(int64_t sn, int64_t destination);
+		void Clear(int64_t sn);
+		void Shift(int64_t sn, double offset);
+		void Receive(int64_t sn, const PacketBatch& batch);
+
+		template<typename TFunction>
+		inline void ForEachBatch(int64_t sn, TFunction function) const
+		{
+			for (const PacketBatch& batch : m_Batches[sn])
+				function(batch);
+		}
+
+	private:
+		std::vector<std::vector<PacketBatch>> m_Batches;
+		std::vector<double> m_OpenTimestamps;
+	};
+
+	// One Packet per collection cycle like ExactPacketStore, but every SN keeps a
+	// singly linked list of packets drawn from a pool owned by the store. Forward
+	// splices the list onto the destination and Clear hands it back to the pool,
+	// both in constant time and without copying packets.
+	class PooledPacketStore
+	{
+	public:
+		PooledPacketStore(size_t nodeCount);
+
+		void Open(int64_t sn, double timestamp, double bitRate);
+		void Close(int64_t sn, double timestamp, double bitRate);
+		void Forward(int64_t sn, int64_t destination);
+		void Clear(int64_t sn);
+		void Shift(int64_t sn, double offset);
+		void Receive(int64_t sn, const PacketBatch& batch);
+
+		template<typename TFunction>
+		inline void ForEachBatch(int64_t sn, TFunction function) const
+		{
+			for (int64_t link = m_Head[sn]; link != c_NullLink; link = m_Pool[link].Next)
+				function(PacketBatch{ m_Pool[link].Value.InitialSNID, 1, m_Pool[link].Value.InitialTimestamp, m_Pool[link].Value.Size });
+		}
+
+	private:
+		struct PacketLink
+		{
+			Packet Value;
+			int64_t Next;
+		};
+
+		int64_t Allocate(const Packet& packet);
+
+		static constexpr int64_t c_NullLink = -1;
+
+		std::vector<PacketLink> m_Pool;
+		int64_t m_FreeHead = c_NullLink;
+
+		std::vector<int64_t> m_Head;
+		std::vector<int64_t> m_Tail;
+		std::vector<int64_t> m_OpenPacket;
+	};
+}
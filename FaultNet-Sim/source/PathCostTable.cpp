@@ -0,0 +1,73 @@
+#include "PCH.h"
+#include "PathCostTable.h"
+
+namespace FaultNet_Sim
+{
+	std::string LossChargingTypeToString(const LossChargingType& lct)
+	{
+		switch (lct)
+		{
+		case LossChargingType::PerPacket:
+			return "PerPacket";
+		case LossChargingType::Grouped:
+			return "Grouped";
+		}
+
+		throw std::runtime_error("Unknown Loss Charging Type in LossChargingTypeToString!");
+		return "";
+	}
+
+	void PathCostTable::Build(const std::vector<SensorNode>& SNs, double transferTime, double energyRateTransfer, double transitionEnergy)
+	{
+		Clear();
+
+		size_t count = SNs.size();
+		m_HopEnergy.resize(count, 0.0);
+		m_Depth.resize(count, -1);
+		m_GroupCount.resize(count, 0);
+		m_GroupSize.resize(count, 0.0);
+		m_IsTouched.resize(count, false);
+
+		for (int i = 0; i < count; i++)
+		{
+			int64_t parent = SNs[i].m_CurrentParent;
+			double distance = 0.0;
+			if (parent == SensorNode::c_BaseStationIndex)
+				distance = std::sqrt(SNs[i].m_Position.X * SNs[i].m_Position.X + SNs[i].m_Position.Y * SNs[i].m_Position.Y);
+			else if (parent >= 0)
+				distance = SensorNode::Distance(SNs[i], SNs[parent]);
+			else
+				continue;
+
+			m_HopEnergy[i] = distance * distance * transferTime * energyRateTransfer + transitionEnergy;
+		}
+
+		std::vector<int64_t> path;
+		for (int i = 0; i < count; i++)
+		{
+			int64_t current = i;
+			while (current >= 0 && m_Depth[current] == -1)
+			{
+				path.push_back(current);
+				current = SNs[current].m_CurrentParent;
+			}
+
+			int64_t depth = current >= 0 ? m_Depth[current] : -1;
+			for (auto it = path.rbegin(); it != path.rend(); it++)
+			{
+				m_Depth[*it] = ++depth;
+			}
+			path.clear();
+		}
+	}
+
+	void PathCostTable::Clear()
+	{
+		m_HopEnergy.clear();
+		m_Depth.clear();
+		m_GroupCount.clear();
+		m_GroupSize.clear();
+		m_IsTouched.clear();
+		m_Touched.clear();
+	}
+}
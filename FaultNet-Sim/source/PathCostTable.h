@@ -0,0 +1,90 @@
+#pragma once
+#include "SensorNodeTable.h"
+#include "PacketStore.h"
+
+namespace FaultNet_Sim
+{
+	enum class LossChargingType
+	{
+		PerPacket = 0,
+		Grouped
+	};
+
+	std::string LossChargingTypeToString(const LossChargingType& lct);
+
+	// Energy spent by each SN to forward one packet to its current parent, fixed
+	// once the topology is constructed, so that lost packets can be charged
+	// without recomputing distances.
+	class PathCostTable
+	{
+	public:
+		void Build(const std::vector<SensorNode>& SNs, double transferTime, double energyRateTransfer, double transitionEnergy);
+		void Clear();
+
+		inline double HopEnergy(int64_t sn) const { return m_HopEnergy[sn]; }
+		inline int64_t Depth(int64_t sn) const { return m_Depth[sn]; }
+
+		// Charges the packets buffered at sn to every SN they passed through, adding
+		// the packets of all origins below an SN together so that each SN of the
+		// union of their paths is charged once.
+		template<typename TPacketStore>
+		void ChargeGrouped(const TPacketStore& packetStore, int64_t sn, SensorNodeTable& snt, double energyRateSensing, double transitionEnergy)
+		{
+			packetStore.ForEachBatch(sn, [&](const PacketBatch& batch)
+				{
+					if (batch.InitialSNID == sn)
+						return;
+
+					Touch(batch.InitialSNID);
+					m_GroupCount[batch.InitialSNID] += batch.Count;
+					m_GroupSize[batch.InitialSNID] += batch.SizeSum;
+				});
+
+			for (int i = 0; i < m_Touched.size(); i++)
+			{
+				int64_t parent = snt.m_CurrentParent[m_Touched[i]];
+				if (parent != sn)
+					Touch(parent);
+			}
+
+			std::sort(m_Touched.begin(), m_Touched.end(),
+				[this](int64_t a, int64_t b) { return m_Depth[a] > m_Depth[b]; });
+
+			for (int64_t current : m_Touched)
+			{
+				snt.m_EnergyWasted[current] += m_GroupSize[current] * energyRateSensing + m_GroupCount[current] * (transitionEnergy + m_HopEnergy[current]);
+
+				int64_t parent = snt.m_CurrentParent[current];
+				if (parent != sn)
+				{
+					m_GroupCount[parent] += m_GroupCount[current];
+					m_GroupSize[parent] += m_GroupSize[current];
+				}
+
+				m_GroupCount[current] = 0;
+				m_GroupSize[current] = 0.0;
+				m_IsTouched[current] = false;
+			}
+
+			m_Touched.clear();
+		}
+
+	private:
+		inline void Touch(int64_t sn)
+		{
+			if (m_IsTouched[sn])
+				return;
+
+			m_IsTouched[sn] = true;
+			m_Touched.push_back(sn);
+		}
+
+		std::vector<double> m_HopEnergy;
+		std::vector<int64_t> m_Depth;
+
+		std::vector<int64_t> m_GroupCount;
+		std::vector<double> m_GroupSize;
+		std::vector<char> m_IsTouched;
+		std::vector<int64_t> m_Touched;
+	};
+}
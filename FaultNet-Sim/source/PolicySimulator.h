@@ -0,0 +1,34 @@
+#pragma once
+#include "Simulator.h"
+#include "SimulationPolicy.h"
+#include "SimulatorEngines.h"
+
+namespace FaultNet_Sim
+{
+	// Simulator built from a policy derived from SimulationPolicy. Topology construction,
+	// coloring, deltas, the termination condition and the transition handlers are all
+	// taken from TPolicy, and the simulation loop is compiled for it.
+	template<typename TPolicy>
+	class PolicySimulator : public Simulator
+	{
+	public:
+		PolicySimulator(SimulatorParameters sp, std::string description = "", TPolicy policy = TPolicy())
+			: Simulator(sp, description), m_Policy(policy) {}
+
+		virtual std::shared_ptr<Simulator> Clone() const override
+		{
+			return std::make_shared<PolicySimulator<TPolicy>>(*this);
+		}
+
+	protected:
+		virtual void ConstructTopology() override { m_Policy.ConstructTopology(m_SensorNodes, *m_NeighborList, m_SimulatorParameters); }
+		virtual void ColorTopology() override { m_Policy.ColorTopology(m_SensorNodes, *m_InterferenceGraph, m_SimulatorParameters, m_SimulatorOptions); }
+		virtual void SetSNDeltas() override { m_Policy.SetSNDeltas(m_SensorNodes, m_SimulatorParameters); }
+
+		virtual bool IsDone(double currentTime) override { return m_Policy.IsDone(m_SimulatorParameters, currentTime); }
+
+		virtual void Simulate() override { SimulateWithPolicy(m_Policy); }
+
+		TPolicy m_Policy;
+	};
+}
@@ -43,9 +43,21 @@ namespace FaultNet_Sim
 						m_HasRun = true;
 
 
+						// Builds the shared neighbor list once up to the largest range of the simulators,
+						// instead of extending it as simulators with larger ranges start.
+						double maxRange = 0.0;
+						for (int i = 0; i < m_Simulators.size(); i++)
+						{
+							SimulatorParameters sp = m_Simulators[i]->GetSimulatorParameters();
+							maxRange = std::max({ maxRange, sp.TransmissionRange, sp.InterferenceRange });
+						}
+
+						if (m_TopologyCache && !m_Simulators.empty())
+							m_TopologyCache->GetNeighborList(maxRange);
+
 						std::vector<std::thread> runThreads;
 
-						auto runFunc = [&](std::shared_ptr<Simulator> sim) { sim->Run(m_ProblemID, m_SensorNodes); s_Semaphore.release(); };
+						auto runFunc = [&](std::shared_ptr<Simulator> sim) { sim->Run(m_ProblemID, m_SensorNodes, m_TopologyCache); s_Semaphore.release(); };
 
 						for (int i = 0; i < m_Simulators.size(); i++)
 						{
@@ -66,14 +78,14 @@ namespace FaultNet_Sim
 
 		static constexpr uint64_t TotalSNCount = 100;
 
-		Distribution dist(DistributionType::Uniform, 300.0 / 2.0,
+		TypedDistribution<DistributionType::Uniform> dist(300.0 / 2.0,
 			std::sqrt(300.0 * 300.0 / 12.0));
 
 
 		for (int SNCount = 0; SNCount < TotalSNCount; SNCount++)
 		{
-			double xPos = dist.GenerateRandomNumber() * (s_RNG() % 2 ? -1 : 1);
-			double yPos = dist.GenerateRandomNumber() * (s_RNG() % 2 ? -1 : 1);
+			double xPos = dist(s_RNG) * (s_RNG() % 2 ? -1 : 1);
+			double yPos = dist(s_RNG) * (s_RNG() % 2 ? -1 : 1);
 
 			SensorNode sn;
 			sn.m_ID = (int64_t)SNCount;
@@ -89,7 +101,7 @@ namespace FaultNet_Sim
 	{
 		static constexpr double failGenerationDuration = 3600 * 24 * 90;
 
-		Distribution uniformDist(DistributionType::Exponential, 3600 * 24, 3600 * 24);
+		TypedDistribution<DistributionType::Exponential> exponentialDist(3600 * 24, 3600 * 24);
 
 		for (int i = 0; i < m_SensorNodes.size(); i++)
 		{
@@ -97,7 +109,7 @@ namespace FaultNet_Sim
 			double timeToNextFailure;
 			while (currentTime < failGenerationDuration)
 			{
-				timeToNextFailure = uniformDist.GenerateRandomNumber();
+				timeToNextFailure = exponentialDist(s_RNG);
 				currentTime += timeToNextFailure;
 				m_SensorNodes[i].m_FailureTimestamps.push_back(currentTime);
 			}
@@ -106,7 +118,21 @@ namespace FaultNet_Sim
 
 	void Problem::GenerateSNsPost()
 	{
+		for (int i = 0; i < m_SensorNodes.size(); i++)
+			m_SensorNodes[i].m_RandomKey = CounterRNG::Key(s_MasterSeed, m_ProblemID, i);
 
+		m_TopologyCache = std::make_shared<TopologyCache>(m_SensorNodes);
+	}
+
+	void Problem::StreamFailures(const Distribution& timeBetweenFailures)
+	{
+		std::shared_ptr<const Distribution> model = std::make_shared<Distribution>(timeBetweenFailures);
+
+		for (int i = 0; i < m_SensorNodes.size(); i++)
+		{
+			m_SensorNodes[i].m_FailureTimestamps.clear();
+			m_SensorNodes[i].m_TimeBetweenFailures = model;
+		}
 	}
 
 	void Problem::GenerateFailuresPost()
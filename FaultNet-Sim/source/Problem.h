@@ -36,12 +36,18 @@ namespace FaultNet_Sim
 		virtual void GenerateFailures();
 
 		void GenerateSNsPost();
+
+		// Lets every SN draw its failures on demand, the time between failures following
+		// timeBetweenFailures, instead of listing them up front. The failures come from the
+		// SN's random key, so all simulators of the problem see the same failures.
+		void StreamFailures(const Distribution& timeBetweenFailures);
 		void GenerateFailuresPost();
 
 		int64_t m_ProblemID;
 		std::string m_Description;
 
 		std::vector<SensorNode> m_SensorNodes;
+		std::shared_ptr<TopologyCache> m_TopologyCache;
 
 		std::vector<std::shared_ptr<Simulator>> m_Simulators;
 
@@ -0,0 +1,49 @@
+#include "PCH.h"
+#include "RoutingTree.h"
+
+namespace FaultNet_Sim
+{
+	void RoutingTree::Build(const std::vector<int64_t>& parents)
+	{
+		size_t count = parents.size();
+
+		m_ChildOffsets.assign(count + 1, 0);
+		for (int64_t parent : parents)
+		{
+			if (parent >= 0)
+				m_ChildOffsets[parent + 1]++;
+		}
+		for (size_t i = 0; i < count; i++)
+			m_ChildOffsets[i + 1] += m_ChildOffsets[i];
+
+		std::vector<int64_t> next(m_ChildOffsets.begin(), m_ChildOffsets.end() - 1);
+		m_Children.resize(m_ChildOffsets[count]);
+		m_Order.clear();
+		m_Order.reserve(count);
+		for (int64_t i = 0; i < count; i++)
+		{
+			if (parents[i] >= 0)
+				m_Children[next[parents[i]]++] = i;
+			else
+				m_Order.push_back(i);
+		}
+
+		for (size_t i = 0; i < m_Order.size(); i++)
+			m_Order.insert(m_Order.end(), ChildrenBegin(m_Order[i]), ChildrenEnd(m_Order[i]));
+
+		m_DescendantCount.assign(count, 0);
+		for (auto it = m_Order.rbegin(); it != m_Order.rend(); it++)
+		{
+			if (parents[*it] >= 0)
+				m_DescendantCount[parents[*it]] += m_DescendantCount[*it] + 1;
+		}
+	}
+
+	void RoutingTree::Clear()
+	{
+		m_ChildOffsets.clear();
+		m_Children.clear();
+		m_DescendantCount.clear();
+		m_Order.clear();
+	}
+}
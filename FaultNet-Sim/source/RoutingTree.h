@@ -0,0 +1,32 @@
+#pragma once
+#include "SensorNode.h"
+
+namespace FaultNet_Sim
+{
+	// Children of every SN in compressed sparse row form, built once from the parents.
+	// SNs whose parent is not an SN are the roots.
+	class RoutingTree
+	{
+	public:
+		void Build(const std::vector<int64_t>& parents);
+		void Clear();
+
+		inline size_t Size() const { return m_DescendantCount.size(); }
+
+		// Children in index order.
+		inline const int64_t* ChildrenBegin(int64_t sn) const { return m_Children.data() + m_ChildOffsets[sn]; }
+		inline const int64_t* ChildrenEnd(int64_t sn) const { return m_Children.data() + m_ChildOffsets[sn + 1]; }
+		inline int64_t ChildCount(int64_t sn) const { return m_ChildOffsets[sn + 1] - m_ChildOffsets[sn]; }
+		inline int64_t DescendantCount(int64_t sn) const { return m_DescendantCount[sn]; }
+
+		// The roots in index order followed by the other SNs level by level, every SN after
+		// its parent. Walking it backwards visits every subtree bottom-up.
+		inline const std::vector<int64_t>& TopDownOrder() const { return m_Order; }
+
+	private:
+		std::vector<int64_t> m_ChildOffsets;
+		std::vector<int64_t> m_Children;
+		std::vector<int64_t> m_DescendantCount;
+		std::vector<int64_t> m_Order;
+	};
+}
@@ -44,6 +44,7 @@ namespace FaultNet_Sim
                     TransmissionRange real,
                     InterferenceRange real,
                     TransferredTotalDuration real,
+                    ColorCount blob,
                     primary key(ProblemID, SimulatorID),
                     foreign key(ProblemID) references Problem(ProblemID)
                 );
@@ -143,6 +144,7 @@ namespace FaultNet_Sim
         sqlite3_bind_double(statement, 10, sData->TransmissionRange);
         sqlite3_bind_double(statement, 11, sData->InterferenceRange);
         sqlite3_bind_double(statement, 12, sData->TransferredTotalDuration);
+        sqlite3_bind_int64(statement, 13, sData->ColorCount);
 
     }
 
@@ -196,7 +198,7 @@ namespace FaultNet_Sim
         std::unordered_map<DataType, SQLiteStatement> statementMap =
         {
             {DataType::ProblemData, SQLiteStatement("INSERT INTO Problem VALUES(?, ?)", bindProblemData)},
-            {DataType::SimulatorData, SQLiteStatement("INSERT INTO Simulator VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", bindSimulatorData)},
+            {DataType::SimulatorData, SQLiteStatement("INSERT INTO Simulator VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", bindSimulatorData)},
             {DataType::SensorNodeData, SQLiteStatement("INSERT INTO SensorNode VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)", bindSNData)},
         };
 
@@ -66,6 +66,14 @@ namespace FaultNet_Sim
 		std::vector<double> m_FailureTimestamps;
 		int64_t m_FailureIterator = 0;
 
+		// If set, the failures are drawn on demand from this distribution of the time between
+		// failures, and m_FailureTimestamps is unused.
+		std::shared_ptr<const Distribution> m_TimeBetweenFailures;
+
+		// Key of the counter-based random streams of the SN, set by its problem from
+		// s_MasterSeed, the problem ID and the SN's index.
+		uint64_t m_RandomKey = 0;
+
 		I_SensorNodeData i_SensorNodeData;
 
 		void Reset();
@@ -76,7 +84,7 @@ namespace FaultNet_Sim
 		static const int64_t c_InvalidIndex = -3;
 
 
-		static inline double Distance(SensorNode a, SensorNode b) 
+		static inline double Distance(const SensorNode& a, const SensorNode& b)
 		{
 			return std::sqrt(
 				(a.m_Position.X - b.m_Position.X) * (a.m_Position.X - b.m_Position.X) +
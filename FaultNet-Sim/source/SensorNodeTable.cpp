@@ -0,0 +1,173 @@
+#include "PCH.h"
+#include "SensorNodeTable.h"
+#include "RoutingTree.h"
+
+namespace FaultNet_Sim
+{
+	void SensorNodeTable::Load(const std::vector<SensorNode>& SNs)
+	{
+		Clear();
+
+		size_t count = SNs.size();
+		m_PositionX.resize(count);
+		m_PositionY.resize(count);
+		m_CurrentParent.resize(count);
+		m_CurrentColor.resize(count);
+		m_DeltaOpt.resize(count);
+		m_CurrentData.resize(count);
+		m_CollectionTime.resize(count);
+		m_WastedTime.resize(count);
+		m_EnergyConsumed.resize(count);
+		m_EnergyWasted.resize(count);
+		m_SentPacketTotalDelay.resize(count);
+		m_SentPacketCount.resize(count);
+		m_TotalDataSent.resize(count);
+		m_Packets.resize(count);
+		m_CurrentPacketIterator.resize(count);
+		m_Failures.resize(count);
+		m_PreviousState.resize(count);
+		m_PreviousTimestamp.resize(count);
+
+		for (int i = 0; i < count; i++)
+		{
+			const SensorNode& sn = SNs[i];
+
+			m_PositionX[i] = sn.m_Position.X;
+			m_PositionY[i] = sn.m_Position.Y;
+			m_CurrentParent[i] = sn.m_CurrentParent;
+			m_CurrentColor[i] = sn.m_CurrentColor;
+			m_DeltaOpt[i] = sn.m_DeltaOpt;
+			m_CurrentData[i] = sn.m_CurrentData;
+			m_CollectionTime[i] = sn.m_CollectionTime;
+			m_WastedTime[i] = sn.m_WastedTime;
+			m_EnergyConsumed[i] = sn.m_EnergyConsumed;
+			m_EnergyWasted[i] = sn.m_EnergyWasted;
+			m_SentPacketTotalDelay[i] = sn.m_SentPacketTotalDelay;
+			m_SentPacketCount[i] = sn.m_SentPacketCount;
+			m_TotalDataSent[i] = sn.m_TotalDataSent;
+			m_Packets[i] = sn.m_Packets;
+			m_CurrentPacketIterator[i] = sn.m_CurrentPacketIterator;
+
+			if (sn.m_TimeBetweenFailures)
+				m_Failures[i] = FailureStream(*sn.m_TimeBetweenFailures, sn.m_RandomKey);
+			else
+				m_Failures[i] = FailureStream(sn.m_FailureTimestamps);
+			for (int64_t k = 0; k < sn.m_FailureIterator; k++)
+				m_Failures[i].Advance();
+
+			m_PreviousState[i] = WorkingState::Collection;
+			m_PreviousTimestamp[i] = 0.0;
+		}
+	}
+
+	void SensorNodeTable::Store(std::vector<SensorNode>& SNs) const
+	{
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			SensorNode& sn = SNs[i];
+
+			sn.m_CurrentParent = m_CurrentParent[i];
+			sn.m_CurrentColor = m_CurrentColor[i];
+			sn.m_DeltaOpt = m_DeltaOpt[i];
+			sn.m_CurrentData = m_CurrentData[i];
+			sn.m_CollectionTime = m_CollectionTime[i];
+			sn.m_WastedTime = m_WastedTime[i];
+			sn.m_EnergyConsumed = m_EnergyConsumed[i];
+			sn.m_EnergyWasted = m_EnergyWasted[i];
+			sn.m_SentPacketTotalDelay = m_SentPacketTotalDelay[i];
+			sn.m_SentPacketCount = m_SentPacketCount[i];
+			sn.m_TotalDataSent = m_TotalDataSent[i];
+			sn.m_CurrentPacketIterator = m_CurrentPacketIterator[i];
+			sn.m_FailureIterator = m_Failures[i].Index();
+		}
+	}
+
+	std::vector<std::vector<int64_t>> SensorNodeTable::RoutingTrees() const
+	{
+		std::vector<int64_t> tree(Size(), -1);
+		std::vector<std::vector<int64_t>> trees;
+
+		std::vector<int64_t> path;
+		for (int i = 0; i < Size(); i++)
+		{
+			int64_t current = i;
+			while (tree[current] == -1)
+			{
+				path.push_back(current);
+				if (m_CurrentParent[current] < 0)
+				{
+					tree[current] = trees.size();
+					trees.emplace_back();
+					break;
+				}
+				current = m_CurrentParent[current];
+			}
+
+			for (int64_t sn : path)
+				tree[sn] = tree[current];
+			path.clear();
+		}
+
+		for (int i = 0; i < Size(); i++)
+			trees[tree[i]].push_back(i);
+
+		return trees;
+	}
+
+	std::vector<std::vector<int64_t>> SensorNodeTable::RoutingSubtrees(size_t targetSize) const
+	{
+		RoutingTree tree;
+		tree.Build(m_CurrentParent);
+		const std::vector<int64_t>& order = tree.TopDownOrder();
+
+		std::vector<size_t> uncutSize(Size(), 1);
+		std::vector<char> isRoot(Size(), false);
+		for (auto it = order.rbegin(); it != order.rend(); it++)
+		{
+			int64_t parent = m_CurrentParent[*it];
+			if (parent < 0 || uncutSize[*it] >= targetSize)
+				isRoot[*it] = true;
+			else
+				uncutSize[parent] += uncutSize[*it];
+		}
+
+		std::vector<int64_t> subtree(Size(), -1);
+		std::vector<std::vector<int64_t>> subtrees;
+		for (int64_t sn : order)
+		{
+			if (isRoot[sn])
+			{
+				subtree[sn] = subtrees.size();
+				subtrees.emplace_back();
+			}
+			else
+				subtree[sn] = subtree[m_CurrentParent[sn]];
+
+			subtrees[subtree[sn]].push_back(sn);
+		}
+
+		return subtrees;
+	}
+
+	void SensorNodeTable::Clear()
+	{
+		m_PositionX.clear();
+		m_PositionY.clear();
+		m_CurrentParent.clear();
+		m_CurrentColor.clear();
+		m_DeltaOpt.clear();
+		m_CurrentData.clear();
+		m_CollectionTime.clear();
+		m_WastedTime.clear();
+		m_EnergyConsumed.clear();
+		m_EnergyWasted.clear();
+		m_SentPacketTotalDelay.clear();
+		m_SentPacketCount.clear();
+		m_TotalDataSent.clear();
+		m_Packets.clear();
+		m_CurrentPacketIterator.clear();
+		m_Failures.clear();
+		m_PreviousState.clear();
+		m_PreviousTimestamp.clear();
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "SensorNode.h"
+#include "FailureStream.h"
+
+namespace FaultNet_Sim
+{
+	// Structure-of-arrays copy of the SN fields touched by the simulation loop.
+	// Load gathers them from the SensorNode objects before simulating, Store
+	// scatters the results back so that the SNs can be logged.
+	class SensorNodeTable
+	{
+	public:
+		void Load(const std::vector<SensorNode>& SNs);
+		void Store(std::vector<SensorNode>& SNs) const;
+		void Clear();
+
+		// SNs grouped by the topmost SN of their route, each group in index order.
+		std::vector<std::vector<int64_t>> RoutingTrees() const;
+
+		// Routing trees cut into subtrees of roughly targetSize SNs, each starting with its
+		// root, so that only the root of a subtree may have a parent in another subtree.
+		std::vector<std::vector<int64_t>> RoutingSubtrees(size_t targetSize) const;
+
+		inline size_t Size() const { return m_CurrentParent.size(); }
+
+		inline double Distance(int64_t a, int64_t b) const
+		{
+			return std::sqrt(
+				(m_PositionX[a] - m_PositionX[b]) * (m_PositionX[a] - m_PositionX[b]) +
+				(m_PositionY[a] - m_PositionY[b]) * (m_PositionY[a] - m_PositionY[b])
+			);
+		}
+
+		inline bool HasNextFailure(int64_t sn) const { return m_Failures[sn].HasNext(); }
+		inline double NextFailure(int64_t sn) const { return m_Failures[sn].Next(); }
+
+		std::vector<double> m_PositionX;
+		std::vector<double> m_PositionY;
+
+		std::vector<int64_t> m_CurrentParent;
+		std::vector<int64_t> m_CurrentColor;
+		std::vector<double> m_DeltaOpt;
+
+		std::vector<double> m_CurrentData;
+
+		std::vector<double> m_CollectionTime;
+		std::vector<double> m_WastedTime;
+
+		std::vector<double> m_EnergyConsumed;
+		std::vector<double> m_EnergyWasted;
+
+		std::vector<double> m_SentPacketTotalDelay;
+		std::vector<int64_t> m_SentPacketCount;
+		std::vector<double> m_TotalDataSent;
+
+		std::vector<std::vector<Packet>> m_Packets;
+		std::vector<int> m_CurrentPacketIterator;
+
+		// Remaining failures of every SN, replaying the timestamps of the SNs they were loaded from.
+		std::vector<FailureStream> m_Failures;
+
+		std::vector<WorkingState> m_PreviousState;
+		std::vector<double> m_PreviousTimestamp;
+	};
+}
@@ -0,0 +1,58 @@
+#include "PCH.h"
+#include "SimulationPartition.h"
+
+namespace FaultNet_Sim
+{
+	SimulationPartition::SimulationPartition(int64_t index, std::vector<int64_t> SNs, const std::vector<int64_t>& partitionOf)
+		: m_Index(index), m_SNs(std::move(SNs)), m_PartitionOf(&partitionOf) {}
+
+	void SimulationPartition::Link(std::vector<SimulationPartition>& partitions, const SensorNodeTable& snt)
+	{
+		int64_t parent = snt.m_CurrentParent[m_SNs.front()];
+		if (parent < 0)
+			return;
+
+		m_ParentPartition = (*m_PartitionOf)[parent];
+		partitions[m_ParentPartition].m_ChildPartitions.push_back(m_Index);
+
+		// A parent without a parent of its own never leaves its initial state.
+		if (snt.m_CurrentParent[parent] == SensorNode::c_NoParentIndex)
+			return;
+
+		m_ForeignParent = parent;
+		m_ForeignParentState = snt.m_PreviousState[parent];
+		m_ForeignParentEvent = { parent, WorkingState::Collection, 0.0 };
+		m_ForeignParentFailures = snt.m_Failures[parent];
+	}
+
+	void SimulationPartition::BeginWindow(int64_t window, size_t outboxSize)
+	{
+		if (m_Outbox.size() != outboxSize)
+		{
+			m_Outbox.resize(outboxSize);
+			m_OutboxBatches.resize(outboxSize);
+		}
+
+		m_Window = window;
+		m_OutboxSlot = window % outboxSize;
+		m_Outbox[m_OutboxSlot].clear();
+		m_OutboxBatches[m_OutboxSlot].clear();
+	}
+
+	void SimulationPartition::GatherMessages(const std::vector<SimulationPartition>& partitions)
+	{
+		m_Inbox.clear();
+		for (int64_t child : m_ChildPartitions)
+		{
+			const SimulationPartition& partition = partitions[child];
+			if (partition.m_IsFinished && partition.m_FinalWindow < m_Window)
+				continue;
+
+			const std::vector<ForwardMessage>& messages = partition.m_Outbox[m_Window % partition.m_Outbox.size()];
+			m_Inbox.insert(m_Inbox.end(), messages.begin(), messages.end());
+		}
+
+		std::sort(m_Inbox.begin(), m_Inbox.end(),
+			[](const ForwardMessage& a, const ForwardMessage& b) { return EventPrecedes(a.Event, b.Event); });
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "SensorNodeTable.h"
+#include "PacketStore.h"
+#include "EventQueue.h"
+
+namespace FaultNet_Sim
+{
+	// Transfer of a partition root to its parent in another partition. Data and the
+	// batches in [BatchBegin, BatchEnd) of Batches are added to Destination once the
+	// partition of Destination reaches Event.
+	struct ForwardMessage
+	{
+		WorkingStateTimestamp Event;
+		int64_t Destination;
+		double Data;
+		const std::vector<PacketBatch>* Batches;
+		size_t BatchBegin;
+		size_t BatchEnd;
+	};
+
+	// Routing subtree simulated by one worker of the parallel engine, one window of
+	// simulated time at a time. Only the root may have a parent in another partition.
+	// That parent's transitions only depend on the parent itself, so they are replayed
+	// here to decide whether a transfer is accepted, and the transfer is sent through
+	// the outbox of the window, which the parent's partition reads a step later.
+	class SimulationPartition
+	{
+	public:
+		SimulationPartition(int64_t index, std::vector<int64_t> SNs, const std::vector<int64_t>& partitionOf);
+
+		inline bool IsLocal(int64_t sn) const { return (*m_PartitionOf)[sn] == m_Index; }
+		inline bool IsForeign(int64_t sn) const { return sn >= 0 && sn == m_ForeignParent; }
+
+		void Link(std::vector<SimulationPartition>& partitions, const SensorNodeTable& snt);
+		void BeginWindow(int64_t window, size_t outboxSize);
+
+		// Messages sent by the child partitions in the current window, in event order.
+		void GatherMessages(const std::vector<SimulationPartition>& partitions);
+
+		template<typename TPacketStore>
+		void Send(const WorkingStateTimestamp& event, int64_t destination, double data, const TPacketStore& packetStore)
+		{
+			std::vector<PacketBatch>& batches = m_OutboxBatches[m_OutboxSlot];
+			size_t batchBegin = batches.size();
+			packetStore.ForEachBatch(event.SNID, [&](const PacketBatch& batch) { batches.push_back(batch); });
+
+			m_Outbox[m_OutboxSlot].push_back({ event, destination, data, &batches, batchBegin, batches.size() });
+		}
+
+		int64_t m_Index;
+		std::vector<int64_t> m_SNs;
+		const std::vector<int64_t>* m_PartitionOf;
+
+		int64_t m_ParentPartition = -1;
+		std::vector<int64_t> m_ChildPartitions;
+		int64_t m_Height = 0;
+
+		BinaryHeapEventQueue m_EventQueue;
+
+		// Replayed timeline of the root's parent if it lies in another partition.
+		int64_t m_ForeignParent = SensorNode::c_InvalidIndex;
+		WorkingState m_ForeignParentState = WorkingState::Collection;
+		WorkingStateTimestamp m_ForeignParentEvent;
+		FailureStream m_ForeignParentFailures;
+
+		int64_t m_Window = -1;
+		size_t m_OutboxSlot = 0;
+		std::vector<std::vector<ForwardMessage>> m_Outbox;
+		std::vector<std::vector<PacketBatch>> m_OutboxBatches;
+		std::vector<ForwardMessage> m_Inbox;
+
+		// Energy wasted by SNs of other partitions on packets lost here, added to the table after the run.
+		std::unordered_map<int64_t, double> m_ForeignEnergyWasted;
+
+		double m_TransferredTotalDuration = 0;
+		int m_FailureCount = 0;
+		double m_CurrentTime = 0.0;
+
+		bool m_HasStopEvent = false;
+		WorkingStateTimestamp m_StopEvent;
+
+		bool m_IsFinished = false;
+		int64_t m_FinalWindow = -1;
+	};
+}
@@ -0,0 +1,116 @@
+#include "PCH.h"
+#include "SimulationPolicy.h"
+
+namespace FaultNet_Sim
+{
+	void SimulationPolicyBase::ConstructTopology(std::vector<SensorNode>& SNs, const NeighborList& neighbors, const SimulatorParameters& sp)
+	{
+
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			if (std::sqrt(SNs[i].m_Position.X * SNs[i].m_Position.X +
+				SNs[i].m_Position.Y * SNs[i].m_Position.Y) < sp.TransmissionRange)
+			{
+				SNs[i].m_Parent = SensorNode::c_BaseStationIndex;
+				SNs[i].m_Level = 0;
+			}
+		}
+		
+		// Breadth first from the SNs in range of the base station. Every SN reached from the
+		// frontier takes the closest frontier SN within range as its parent, ties going to the
+		// lowest index, which is the first one in its neighbor list.
+		std::vector<int64_t> frontier;
+		std::vector<int64_t> nextFrontier;
+		std::vector<char> isReached(SNs.size(), false);
+
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			if (SNs[i].m_Level == 0)
+				frontier.push_back(i);
+		}
+
+		int currentLevel = 1;
+
+		while (!frontier.empty())
+		{
+			nextFrontier.clear();
+
+			for (int64_t j : frontier)
+			{
+				for (int64_t k = neighbors.Begin(j); k < neighbors.EndBelow(j, sp.TransmissionRange); k++)
+				{
+					int64_t i = neighbors.Neighbor(k);
+					if (SNs[i].m_Parent != SensorNode::c_InvalidIndex || isReached[i])
+						continue;
+
+					isReached[i] = true;
+					nextFrontier.push_back(i);
+				}
+			}
+
+			for (int64_t i : nextFrontier)
+			{
+				for (int64_t k = neighbors.Begin(i); SNs[i].m_Parent == SensorNode::c_InvalidIndex; k++)
+				{
+					if (SNs[neighbors.Neighbor(k)].m_Level == currentLevel - 1)
+						SNs[i].m_Parent = neighbors.Neighbor(k);
+				}
+				SNs[i].m_Level = currentLevel;
+			}
+
+			std::swap(frontier, nextFrontier);
+			currentLevel++;
+		}
+
+
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			if (SNs[i].m_Parent == SensorNode::c_InvalidIndex)
+			{
+				SNs[i].m_Parent = SensorNode::c_NoParentIndex;
+			}
+		}
+
+		std::vector<int64_t> parents(SNs.size());
+		for (int i = 0; i < SNs.size(); i++)
+			parents[i] = SNs[i].m_Parent;
+
+		RoutingTree tree;
+		tree.Build(parents);
+
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			SNs[i].m_ChildCount = (int)tree.ChildCount(i);
+			SNs[i].m_DescendantCount = (int)tree.DescendantCount(i);
+		}
+
+	}
+
+	void SimulationPolicyBase::ColorTopology(std::vector<SensorNode>& SNs, const InterferenceGraph& graph, const SimulatorParameters& sp, const SimulatorOptions& so)
+	{
+		std::vector<char> include(SNs.size());
+		for (int i = 0; i < SNs.size(); i++)
+			include[i] = SNs[i].m_Parent != SensorNode::c_NoParentIndex;
+
+		std::vector<int64_t> colors = ColorGraph(graph, include, so.Coloring, so.ThreadCount, so.ColoringSeed);
+
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			if (include[i])
+				SNs[i].m_Color = colors[i];
+		}
+	}
+
+	void SimulationPolicyBase::SetSNDeltas(std::vector<SensorNode>& SNs, const SimulatorParameters& sp)
+	{
+		Distribution uniformDist(DistributionType::Uniform, 1000.0, 1.0);
+		
+		for (int i = 0; i < SNs.size(); i++)
+			SNs[i].m_DeltaOpt = 0.0;
+	}
+
+	bool SimulationPolicyBase::IsDone(const SimulatorParameters& sp, double currentTime)
+	{
+		return currentTime >= sp.TotalSimulationTime;
+	}
+}
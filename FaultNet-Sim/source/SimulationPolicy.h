@@ -0,0 +1,216 @@
+#pragma once
+#include "Simulator.h"
+
+namespace FaultNet_Sim
+{
+	// What a transition handler works on while an event is processed. PreviousTimestamp is the
+	// timestamp of the SN's previous transition, the table still holds its previous state.
+	struct TransitionContext
+	{
+		SensorNodeTable& Table;
+		const SimulatorParameters& Parameters;
+		const SimulatorOptions& Options;
+		PathCostTable& PathCosts;
+		double PreviousTimestamp;
+		double& TransferredTotalDuration;
+		int& FailureCount;
+		SimulationPartition* Partition;
+	};
+
+	// Defaults of the customization points that only run once per simulation.
+	class SimulationPolicyBase
+	{
+	public:
+		static constexpr double c_EnergyTransitionWorkingToTransfer = 0.0;
+		static constexpr double c_EnergyTransitionTransferToWorking = 0.0;
+		static constexpr double c_BitRate = 21.28;
+
+		static void ConstructTopology(std::vector<SensorNode>& SNs, const NeighborList& neighbors, const SimulatorParameters& sp);
+		static void ColorTopology(std::vector<SensorNode>& SNs, const InterferenceGraph& graph, const SimulatorParameters& sp, const SimulatorOptions& so);
+		static void SetSNDeltas(std::vector<SensorNode>& SNs, const SimulatorParameters& sp);
+
+		static bool IsDone(const SimulatorParameters& sp, double currentTime);
+	};
+
+	// Customization points of a simulator resolved at compile time. A policy derives from
+	// SimulationPolicy<TDerived> and hides the members it wants to change, PolicySimulator then
+	// runs the simulation loop with the members of the policy called directly. The handlers
+	// are named after the transition of the SN from its previous state to the state of the event.
+	template<typename TDerived>
+	class SimulationPolicy : public SimulationPolicyBase
+	{
+	public:
+		template<typename TPacketStore>
+		void OnCollectionToCollection(TransitionContext& context, const WorkingStateTimestamp& event, TPacketStore& packetStore)
+		{
+			packetStore.Open(event.SNID, event.Timestamp, c_BitRate);
+		}
+
+		template<typename TPacketStore>
+		void OnCollectionToTransfer(TransitionContext& context, const WorkingStateTimestamp& event, TPacketStore& packetStore)
+		{
+			SensorNodeTable& snt = context.Table;
+			const int64_t& currentSN = event.SNID;
+			double duration = event.Timestamp - context.PreviousTimestamp;
+
+			snt.m_CollectionTime[currentSN] += duration;
+			snt.m_CurrentData[currentSN] += duration * c_BitRate;
+			snt.m_EnergyConsumed[currentSN] += duration * context.Parameters.EnergyRateSensing + c_EnergyTransitionWorkingToTransfer;
+			packetStore.Close(currentSN, event.Timestamp, c_BitRate);
+		}
+
+		template<typename TPacketStore>
+		void OnCollectionToRecovery(TransitionContext& context, const WorkingStateTimestamp& event, TPacketStore& packetStore)
+		{
+			SensorNodeTable& snt = context.Table;
+			const int64_t& currentSN = event.SNID;
+			double duration = event.Timestamp - context.PreviousTimestamp;
+
+			snt.m_EnergyWasted[currentSN] += duration * context.Parameters.EnergyRateSensing;
+			Derived().ChargeLostPackets(context, packetStore, currentSN);
+
+			snt.m_WastedTime[currentSN] += duration;
+			context.FailureCount++;
+			snt.m_EnergyConsumed[currentSN] += duration * context.Parameters.EnergyRateSensing;
+			snt.m_CurrentData[currentSN] = 0;
+			packetStore.Clear(currentSN);
+		}
+
+		// parentState is the state the parent was left in by its last transition, the base station always receives.
+		template<typename TPacketStore>
+		void OnTransferToCollection(TransitionContext& context, const WorkingStateTimestamp& event, TPacketStore& packetStore, WorkingState parentState)
+		{
+			SensorNodeTable& snt = context.Table;
+			const int64_t& currentSN = event.SNID;
+			int64_t currentParent = snt.m_CurrentParent[currentSN];
+
+			if (currentParent == SensorNode::c_NoParentIndex)
+			{
+				packetStore.Clear(currentSN);
+				snt.m_CurrentData[currentSN] = 0;
+				return;
+			}
+
+			bool isAccepted = currentParent == SensorNode::c_BaseStationIndex || parentState != WorkingState::Recovery;
+
+			if (currentParent != SensorNode::c_BaseStationIndex)
+			{
+				if (isAccepted && context.Partition && context.Partition->IsForeign(currentParent))
+					context.Partition->Send(event, currentParent, snt.m_CurrentData[currentSN], packetStore);
+				else if (isAccepted)
+				{
+					snt.m_CurrentData[currentParent] += snt.m_CurrentData[currentSN];
+					packetStore.Forward(currentSN, currentParent);
+				}
+			}
+			else
+			{
+				context.TransferredTotalDuration += snt.m_CurrentData[currentSN];
+				packetStore.ForEachBatch(currentSN, [&](const PacketBatch& batch)
+					{
+						snt.m_SentPacketTotalDelay[batch.InitialSNID] += batch.Count * event.Timestamp - batch.InitialTimestampSum;
+						snt.m_SentPacketCount[batch.InitialSNID] += batch.Count;
+
+						snt.m_TotalDataSent[batch.InitialSNID] += batch.SizeSum;
+					});
+			}
+
+			double distance = Derived().TransferDistance(snt, currentSN);
+
+			if (isAccepted)
+			{
+				packetStore.Clear(currentSN);
+				snt.m_CurrentData[currentSN] = 0;
+			}
+			snt.m_EnergyConsumed[currentSN] += distance * distance * (event.Timestamp - context.PreviousTimestamp) * context.Parameters.EnergyRateTransfer + c_EnergyTransitionTransferToWorking;
+
+			snt.m_WastedTime[currentSN] += context.Parameters.TransferTime;
+			packetStore.Open(currentSN, event.Timestamp, c_BitRate);
+		}
+
+		template<typename TPacketStore>
+		void OnTransferToRecovery(TransitionContext& context, const WorkingStateTimestamp& event, TPacketStore& packetStore)
+		{
+			SensorNodeTable& snt = context.Table;
+			const int64_t& currentSN = event.SNID;
+			double duration = event.Timestamp - context.PreviousTimestamp;
+
+			snt.m_WastedTime[currentSN] += duration;
+			context.FailureCount++;
+
+			Derived().ChargeLostPackets(context, packetStore, currentSN);
+
+			double distance = Derived().TransferDistance(snt, currentSN);
+
+			snt.m_EnergyConsumed[currentSN] += distance * distance * duration * context.Parameters.EnergyRateTransfer + c_EnergyTransitionTransferToWorking;
+			snt.m_EnergyWasted[currentSN] += distance * distance * duration * context.Parameters.EnergyRateTransfer + c_EnergyTransitionTransferToWorking;
+
+			snt.m_CurrentData[currentSN] = 0;
+			packetStore.Clear(currentSN);
+		}
+
+		template<typename TPacketStore>
+		void OnRecoveryToCollection(TransitionContext& context, const WorkingStateTimestamp& event, TPacketStore& packetStore)
+		{
+			context.Table.m_WastedTime[event.SNID] += context.Parameters.RecoveryTime;
+			packetStore.Open(event.SNID, event.Timestamp, c_BitRate);
+		}
+
+		template<typename TPacketStore>
+		void OnRecoveryToRecovery(TransitionContext& context, const WorkingStateTimestamp& event, TPacketStore& packetStore)
+		{
+			SensorNodeTable& snt = context.Table;
+
+			snt.m_WastedTime[event.SNID] += event.Timestamp - context.PreviousTimestamp;
+			context.FailureCount++;
+			snt.m_CurrentData[event.SNID] = 0;
+			packetStore.Clear(event.SNID);
+		}
+
+		// Charges the packets lost when sn fails to every SN they passed through.
+		template<typename TPacketStore>
+		void ChargeLostPackets(TransitionContext& context, const TPacketStore& packetStore, int64_t sn)
+		{
+			SensorNodeTable& snt = context.Table;
+			SimulationPartition* partition = context.Partition;
+
+			// The scratch space of the path cost table is shared, so partitions charge per packet.
+			if (context.Options.LossCharging == LossChargingType::Grouped && !partition)
+			{
+				context.PathCosts.ChargeGrouped(packetStore, sn, snt, context.Parameters.EnergyRateSensing, c_EnergyTransitionWorkingToTransfer);
+				return;
+			}
+
+			packetStore.ForEachBatch(sn, [&](const PacketBatch& batch)
+				{
+					int64_t energyCurrentSN = batch.InitialSNID;
+					while (energyCurrentSN != sn)
+					{
+						double& energyWasted = partition && !partition->IsLocal(energyCurrentSN) ? partition->m_ForeignEnergyWasted[energyCurrentSN] : snt.m_EnergyWasted[energyCurrentSN];
+						energyWasted += batch.SizeSum * context.Parameters.EnergyRateSensing + batch.Count * c_EnergyTransitionWorkingToTransfer;
+						energyWasted += batch.Count * context.PathCosts.HopEnergy(energyCurrentSN);
+
+						energyCurrentSN = snt.m_CurrentParent[energyCurrentSN];
+					}
+				});
+		}
+
+		// Distance the transmission of sn covers, the base station sits at the origin.
+		inline double TransferDistance(const SensorNodeTable& snt, int64_t sn)
+		{
+			int64_t parent = snt.m_CurrentParent[sn];
+			if (parent != SensorNode::c_BaseStationIndex)
+				return snt.Distance(sn, parent);
+
+			double posx = snt.m_PositionX[sn];
+			double posy = snt.m_PositionX[sn];
+			return std::sqrt(posx * posx + posy * posy);
+		}
+
+	protected:
+		inline TDerived& Derived() { return static_cast<TDerived&>(*this); }
+	};
+
+	// The behavior of Simulator, as a policy to build on.
+	class DefaultSimulationPolicy : public SimulationPolicy<DefaultSimulationPolicy> {};
+}
@@ -1,14 +1,29 @@
 #include "PCH.h"
 #include "Simulator.h"
+#include "SimulatorEngines.h"
 #include "DatabaseData.h"
 #include "SQLiteDatabase.h"
 
 namespace FaultNet_Sim
 {
 
-	static constexpr double s_EnergyTransitionWorkingToTransfer = 0.0;
-	static constexpr double s_EnergyTransitionTransferToWorking = 0.0;
-	static constexpr double s_BitRate = 21.28;
+	std::string SimulationEngineTypeToString(const SimulationEngineType& set)
+	{
+		switch (set)
+		{
+		case SimulationEngineType::EventDriven:
+			return "EventDriven";
+		case SimulationEngineType::FastForward:
+			return "FastForward";
+		case SimulationEngineType::SlotSynchronous:
+			return "SlotSynchronous";
+		case SimulationEngineType::Parallel:
+			return "Parallel";
+		}
+
+		throw std::runtime_error("Unknown Simulation Engine Type in SimulationEngineTypeToString!");
+		return "";
+	}
 
 	int64_t Simulator::GenerateID()
 	{
@@ -23,9 +38,9 @@ namespace FaultNet_Sim
 		: m_SimulatorID(GenerateID()), m_SimulatorParameters(sp), m_Description(description) {}
 
 	Simulator::Simulator(const Simulator& other)
-		: m_SimulatorID(other.m_SimulatorID), m_SimulatorParameters(other.m_SimulatorParameters), i_SimulatorData(other.i_SimulatorData), m_Description(other.m_Description) {}
+		: m_SimulatorID(other.m_SimulatorID), m_SimulatorParameters(other.m_SimulatorParameters), m_SimulatorOptions(other.m_SimulatorOptions), i_SimulatorData(other.i_SimulatorData), m_Description(other.m_Description) {}
 	
-	void Simulator::Run(int64_t problemID, const std::vector<SensorNode>& SNs)
+	void Simulator::Run(int64_t problemID, const std::vector<SensorNode>& SNs, std::shared_ptr<TopologyCache> topologyCache)
 	{
 		{
 			std::unique_lock<std::mutex> lock(g_PrintMutex);
@@ -34,10 +49,29 @@ namespace FaultNet_Sim
 
 		m_ProblemID = problemID;
 		m_SensorNodes = SNs;
+		m_TopologyCache = topologyCache ? topologyCache : std::make_shared<TopologyCache>(SNs);
+		m_SpatialIndex = m_TopologyCache->GetSpatialIndex();
+		m_NeighborList = m_TopologyCache->GetNeighborList(std::max(m_SimulatorParameters.TransmissionRange, m_SimulatorParameters.InterferenceRange));
+		m_InterferenceGraph = m_TopologyCache->GetInterferenceGraph(m_SimulatorParameters.InterferenceRange);
+
+		auto constructTopology = [&]()
+			{
+				ConstructTopology();
+				ConstructTopologyPost();
+				ColorTopology();
+			};
+
+		if (m_SimulatorOptions.CacheTopology)
+		{
+			TopologyKey key = { typeid(*this), m_SimulatorParameters.TransmissionRange, m_SimulatorParameters.InterferenceRange,
+				m_SimulatorOptions.Coloring, m_SimulatorOptions.ColoringSeed };
+
+			if (m_TopologyCache->ApplyTopology(key, m_SensorNodes, constructTopology))
+				ConstructTopologyPost();
+		}
+		else
+			constructTopology();
 
-		ConstructTopology();
-		ConstructTopologyPost();
-		ColorTopology();
 		ColorTopologyPost();
 		SetSNDeltas();
 		SetSNDeltasPost();
@@ -51,184 +85,40 @@ namespace FaultNet_Sim
 
 	void Simulator::ConstructTopology()
 	{
-
-		for (int i = 0; i < m_SensorNodes.size(); i++)
-		{
-			if (std::sqrt(m_SensorNodes[i].m_Position.X * m_SensorNodes[i].m_Position.X +
-				m_SensorNodes[i].m_Position.Y * m_SensorNodes[i].m_Position.Y) < m_SimulatorParameters.TransmissionRange)
-			{
-				m_SensorNodes[i].m_Parent = SensorNode::c_BaseStationIndex;
-				m_SensorNodes[i].m_Level = 0;
-			}
-		}
-		
-		int currentLevel = 1;
-		bool done = false;
-		bool assigned = true;
-
-
-		while (!done && assigned)
-		{
-			done = true;
-			assigned = false;
-
-			for (int i = 0; i < m_SensorNodes.size(); i++)
-			{
-				if (m_SensorNodes[i].m_Parent != SensorNode::c_InvalidIndex)
-					continue;
-
-
-
-				struct IDDistance
-				{
-					int64_t SNID;
-					double Distance;
-				};
-
-				std::vector<IDDistance> temp;
-
-				for (int j = 0; j < m_SensorNodes.size(); j++)
-				{
-					if (m_SensorNodes[j].m_Level != currentLevel - 1)
-						continue;
-
-					double distance = SensorNode::Distance(m_SensorNodes[i], m_SensorNodes[j]);
-
-					if (distance < m_SimulatorParameters.TransmissionRange)
-						temp.push_back({ (int64_t)j, distance });
-
-				}
-
-				if (temp.empty())
-				{
-					done = false;
-					continue;
-				}
-				assigned = true;
-
-
-				int closestIndex = -1;
-				double closestDistance = std::numeric_limits<double>::max();
-				for (int j = 0; j < temp.size(); j++)
-				{
-					if (closestDistance > temp[j].Distance)
-					{
-						closestIndex = temp[j].SNID;
-						closestDistance = temp[j].Distance;
-					}
-				}
-
-				m_SensorNodes[i].m_Parent = closestIndex;
-				m_SensorNodes[i].m_Level = currentLevel;
-			}
-
-
-			currentLevel++;
-		}
-
-
-		for (int i = 0; i < m_SensorNodes.size(); i++)
-		{
-			if (m_SensorNodes[i].m_Parent == SensorNode::c_InvalidIndex)
-			{
-				m_SensorNodes[i].m_Parent = SensorNode::c_NoParentIndex;
-			}
-		}
-
-		for (int i = 0; i < m_SensorNodes.size(); i++)
-		{
-			m_SensorNodes[i].m_ChildCount = 0;
-			m_SensorNodes[i].m_DescendantCount = 0;
-		}
-
-		for (int i = 0; i < m_SensorNodes.size(); i++)
-		{
-			int64_t currentParent = m_SensorNodes[i].m_Parent;
-			if(currentParent != SensorNode::c_BaseStationIndex && currentParent != SensorNode::c_InvalidIndex && currentParent != SensorNode::c_NoParentIndex)
-				m_SensorNodes[m_SensorNodes[i].m_Parent].m_ChildCount++;
-			while (currentParent != SensorNode::c_BaseStationIndex && currentParent != SensorNode::c_InvalidIndex && currentParent != SensorNode::c_NoParentIndex)
-			{
-				m_SensorNodes[currentParent].m_DescendantCount++;
-				currentParent = m_SensorNodes[currentParent].m_Parent;
-			}
-		}
-
+		SimulationPolicyBase::ConstructTopology(m_SensorNodes, *m_NeighborList, m_SimulatorParameters);
 	}
 
 	void Simulator::ColorTopology()
 	{
-		std::vector<SensorNode> tempSN = m_SensorNodes;
-
-		for (int i = 0; i < tempSN.size(); i++)
-		{
-			if (tempSN[i].m_Parent == SensorNode::c_NoParentIndex)
-			{
-				tempSN.erase(tempSN.begin() + i);
-				i--;
-			}
-		}
-
-		for (int i = 0; i < tempSN.size(); i++)
-		{
-			for (int j = 0; j < tempSN.size(); j++)
-			{
-				if (SensorNode::Distance(tempSN[i], tempSN[j]) <= m_SimulatorParameters.InterferenceRange)
-				{
-					if (tempSN[i].m_WelshPowellDegree == -1)
-						tempSN[i].m_WelshPowellDegree = 0;
-					tempSN[i].m_WelshPowellDegree++;
-				}
-			}
-		}
-
-		std::sort(tempSN.begin(), tempSN.end(), [&](SensorNode sn1, SensorNode sn2) {
-			return sn1.m_WelshPowellDegree > sn2.m_WelshPowellDegree;
-			});
-
-		bool exists = true;
-		for (int i = 0; exists; i++)
-		{
-			exists = false;
-			for (int j = 0; j < tempSN.size(); j++)
-			{
-				if (tempSN[j].m_Color != -1)
-					continue;
-				bool con = false;
-				for (int k = 0; k < tempSN.size(); k++)
-					if (tempSN[k].m_Color == i && SensorNode::Distance(tempSN[j], tempSN[k]) <= m_SimulatorParameters.InterferenceRange) {
-						con = true;
-						break;
-					}
-				if (!con) {
-					tempSN[j].m_Color = i;
-					exists = true;
-				}
-			}
-		}
-
-		for (int i = 0; i < tempSN.size(); i++)
-			m_SensorNodes[tempSN[i].m_ID].m_Color = tempSN[i].m_Color;
+		SimulationPolicyBase::ColorTopology(m_SensorNodes, *m_InterferenceGraph, m_SimulatorParameters, m_SimulatorOptions);
 	}
 
 	void Simulator::SetSNDeltas()
 	{
-		Distribution uniformDist(DistributionType::Uniform, 1000.0, 1.0);
-		
-		for (int i = 0; i < m_SensorNodes.size(); i++)
-			m_SensorNodes[i].m_DeltaOpt = 0.0;
+		SimulationPolicyBase::SetSNDeltas(m_SensorNodes, m_SimulatorParameters);
 	}
 
 	void Simulator::ConstructTopologyPost()
 	{
+		std::vector<int64_t> parents(m_SensorNodes.size());
 		for (int i = 0; i < m_SensorNodes.size(); i++)
+		{
 			m_SensorNodes[i].m_CurrentParent = m_SensorNodes[i].m_Parent;
+			parents[i] = m_SensorNodes[i].m_Parent;
+		}
+		m_RoutingTree.Build(parents);
 
+		m_PathCostTable.Build(m_SensorNodes, m_SimulatorParameters.TransferTime, m_SimulatorParameters.EnergyRateTransfer, SimulationPolicyBase::c_EnergyTransitionTransferToWorking);
 	}
 
 	void Simulator::ColorTopologyPost()
 	{
+		m_SimulatorResults.ColorCount = 0;
 		for (int i = 0; i < m_SensorNodes.size(); i++)
+		{
 			m_SensorNodes[i].m_CurrentColor = m_SensorNodes[i].m_Color;
+			m_SimulatorResults.ColorCount = std::max(m_SimulatorResults.ColorCount, m_SensorNodes[i].m_Color + 1);
+		}
 
 	}
 
@@ -237,277 +127,105 @@ namespace FaultNet_Sim
 
 	}
 
+	// Calls the virtual IsDone, so that simulators deriving from Simulator directly can still override it.
+	class VirtualSimulationPolicy : public SimulationPolicy<VirtualSimulationPolicy>
+	{
+	public:
+		VirtualSimulationPolicy(Simulator& simulator)
+			: m_Simulator(simulator) {}
+
+		inline bool IsDone(const SimulatorParameters& sp, double currentTime) { return m_Simulator.IsDone(currentTime); }
+
+	private:
+		Simulator& m_Simulator;
+	};
+
 	void Simulator::Simulate()
 	{
-		SimulatorResults& sr = m_SimulatorResults;
-			
-		struct WorkingStateTimestamp
-		{
-			int64_t SNID;
-			WorkingState State;
-			double Timestamp;
-		};
-
-		std::unordered_map<int64_t, WorkingStateTimestamp> previousEvents;
-		auto pqCompare = [](WorkingStateTimestamp left, WorkingStateTimestamp right) 
-		{ 
-			if (left.Timestamp > right.Timestamp)
-				return true;
-			else if (left.Timestamp < right.Timestamp)
-				return false;
-
-			return left.SNID < right.SNID;
-		};
-
-		std::priority_queue<WorkingStateTimestamp, std::vector<WorkingStateTimestamp>, decltype(pqCompare)> eventQueue(pqCompare);
-		for (int i = 0; i < m_SensorNodes.size(); i++)
+		VirtualSimulationPolicy policy(*this);
+		SimulateWithPolicy(policy);
+	}
+
+	int64_t Simulator::SkippablePeriods(const std::vector<int64_t>& tree, const std::vector<WorkingStateTimestamp>& pendingEvents, double period)
+	{
+		SensorNodeTable& snt = m_SensorNodeTable;
+
+		// Every SN has to schedule its transitions of the skipped superslots before its next failure.
+		int64_t periods = std::numeric_limits<int64_t>::max();
+		for (int64_t sn : tree)
 		{
-			if(m_SensorNodes[i].m_CurrentParent == SensorNode::c_NoParentIndex)
+			if (snt.m_CurrentParent[sn] == SensorNode::c_NoParentIndex || !snt.HasNextFailure(sn))
 				continue;
-			eventQueue.push({ (int64_t)i, WorkingState::Collection, 0.0 });
-			previousEvents[(int64_t)i] = {(int64_t)i, WorkingState::Collection, 0.0};
+			periods = std::min(periods, (int64_t)std::floor((snt.NextFailure(sn) - pendingEvents[sn].Timestamp) / period) - 1);
 		}
-		
 
-		int colorCount = -1;
-		for (int i = 0; i < m_SensorNodes.size(); i++)
-			colorCount = std::max(colorCount, (int)m_SensorNodes[i].m_Color);
-		colorCount++;
+		if (periods == std::numeric_limits<int64_t>::max())
+			periods = (int64_t)std::ceil(m_SimulatorParameters.TotalSimulationTime / period);
 
-		double transferredTotalDuration = 0;
-		double currentTime = 0.0;
-		int failureCount = 0;
+		return periods;
+	}
 
-		int superSlotIterator = 0;
+	WorkingStateTimestamp Simulator::NextEvent(const WorkingStateTimestamp& currentEvent, int colorCount, FailureStream& failures) const
+	{
+		const SensorNodeTable& snt = m_SensorNodeTable;
 
-		bool isDone = false;
+		double currentTime = currentEvent.Timestamp;
+		const WorkingState& currentState = currentEvent.State;
+		const int64_t& currentSN = currentEvent.SNID;
 
-		while (!isDone && !eventQueue.empty())
+		double nextTime = currentTime;
+		WorkingState nextState;
+		if (currentState == WorkingState::Collection)
 		{
-			auto currentEvent = eventQueue.top();
-			currentTime = currentEvent.Timestamp;
-			auto& currentState = currentEvent.State;
-			auto& currentSN = currentEvent.SNID;
-			eventQueue.pop();
-
-
-			superSlotIterator = currentTime / (m_SimulatorParameters.TransferTime * colorCount);
+			double optimalTime = currentTime + snt.m_DeltaOpt[currentSN];
+			int k = ceil((((currentTime + snt.m_DeltaOpt[currentSN]) / m_SimulatorParameters.TransferTime) - snt.m_CurrentColor[currentSN]) / colorCount);
+			nextTime = (k * colorCount + snt.m_CurrentColor[currentSN]) * m_SimulatorParameters.TransferTime;
 
+			if(std::abs(nextTime - optimalTime) > std::abs((nextTime - m_SimulatorParameters.TransferTime * colorCount) - optimalTime))
+				nextTime -= m_SimulatorParameters.TransferTime * colorCount;
+			while(nextTime < currentTime)
+				nextTime += m_SimulatorParameters.TransferTime * colorCount;
 
-			{
-				double nextTime = currentTime;
-				WorkingState nextState;
-				if (currentState == WorkingState::Collection)
-				{
-						
-
-					double optimalTime = currentTime + m_SensorNodes[currentSN].m_DeltaOpt;
-					int k = ceil((((currentTime + m_SensorNodes[currentSN].m_DeltaOpt) / m_SimulatorParameters.TransferTime) - m_SensorNodes[currentSN].m_CurrentColor) / colorCount);
-					nextTime = (k * colorCount + m_SensorNodes[currentSN].m_CurrentColor) * m_SimulatorParameters.TransferTime;
-
-					if(std::abs(nextTime - optimalTime) > std::abs((nextTime - m_SimulatorParameters.TransferTime * colorCount) - optimalTime))
-						nextTime -= m_SimulatorParameters.TransferTime * colorCount;
-					while(nextTime < currentTime)
-						nextTime += m_SimulatorParameters.TransferTime * colorCount;
-
-					nextState = WorkingState::Transfer;
-
-				}
-				else if (currentState == WorkingState::Transfer)
-				{
-					nextTime += m_SimulatorParameters.TransferTime;
-					nextState = WorkingState::Collection;
-				}
-				else if (currentState == WorkingState::Recovery)
-				{
-					nextTime += m_SimulatorParameters.RecoveryTime;
-					nextState = WorkingState::Collection;
-				}
-
-				if (m_SensorNodes[currentSN].m_FailureIterator >= m_SensorNodes[currentSN].m_FailureTimestamps.size())
-					std::cout << "Ran out of failures!\n";
-				if (m_SensorNodes[currentSN].m_FailureIterator < m_SensorNodes[currentSN].m_FailureTimestamps.size() &&
-					nextTime >= m_SensorNodes[currentSN].m_FailureTimestamps[m_SensorNodes[currentSN].m_FailureIterator])
-				{
-					eventQueue.push({ currentSN, WorkingState::Recovery, m_SensorNodes[currentSN].m_FailureTimestamps[m_SensorNodes[currentSN].m_FailureIterator] });
-					m_SensorNodes[currentSN].m_FailureIterator++;
-				}
-				else
-				{
-					eventQueue.push({ currentSN, nextState, nextTime });
-				}
-			}
-
-			if (previousEvents[currentSN].State == WorkingState::Collection)
-			{
-				if (currentState == WorkingState::Collection)
-				{
-					m_SensorNodes[currentSN].m_Packets.push_back({ currentSN, currentTime });
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = m_SensorNodes[currentSN].m_Packets.size() - 1;
-				}
-				else if (currentState == WorkingState::Transfer)
-				{
-					m_SensorNodes[currentSN].m_CollectionTime += currentTime - previousEvents[currentSN].Timestamp;
-					m_SensorNodes[currentSN].m_CurrentData += (currentTime - previousEvents[currentSN].Timestamp) * s_BitRate;
-					m_SensorNodes[currentSN].m_EnergyConsumed += (currentTime - previousEvents[currentSN].Timestamp) * m_SimulatorParameters.EnergyRateSensing + s_EnergyTransitionWorkingToTransfer;
-					m_SensorNodes[currentSN].m_Packets[m_SensorNodes[currentSN].m_CurrentPacketIterator].Size = (currentTime - m_SensorNodes[currentSN].m_Packets[m_SensorNodes[currentSN].m_CurrentPacketIterator].InitialTimestamp) * s_BitRate;
-				}
-				else if (currentState == WorkingState::Recovery)
-				{
-					m_SensorNodes[currentSN].m_EnergyWasted += (currentTime - previousEvents[currentSN].Timestamp) * m_SimulatorParameters.EnergyRateSensing;
-					{
-						for (int i = 0; i < m_SensorNodes[currentSN].m_Packets.size(); i++)
-						{
-							int energyCurrentSN = m_SensorNodes[currentSN].m_Packets[i].InitialSNID;
-							while (energyCurrentSN != currentSN)
-							{
-								double distance = SensorNode::Distance(m_SensorNodes[energyCurrentSN], m_SensorNodes[m_SensorNodes[energyCurrentSN].m_CurrentParent]);
-								m_SensorNodes[energyCurrentSN].m_EnergyWasted += m_SensorNodes[currentSN].m_Packets[i].Size * m_SimulatorParameters.EnergyRateSensing + s_EnergyTransitionWorkingToTransfer;
-								m_SensorNodes[energyCurrentSN].m_EnergyWasted += distance * distance * m_SimulatorParameters.TransferTime * m_SimulatorParameters.EnergyRateTransfer + s_EnergyTransitionTransferToWorking;
-
-								energyCurrentSN = m_SensorNodes[energyCurrentSN].m_CurrentParent;
-							}
-						}
-					}
-
-					m_SensorNodes[currentSN].m_WastedTime += currentTime - previousEvents[currentSN].Timestamp;
-					failureCount++;
-					m_SensorNodes[currentSN].m_EnergyConsumed += (currentTime - previousEvents[currentSN].Timestamp) * m_SimulatorParameters.EnergyRateSensing;
-					m_SensorNodes[currentSN].m_CurrentData = 0;
-					m_SensorNodes[currentSN].m_Packets.clear();
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = - 1;
-				}
-			}
-			else if (previousEvents[currentSN].State == WorkingState::Transfer)
-			{
-				if (currentState == WorkingState::Collection)
-				{
-					if(m_SensorNodes[currentSN].m_CurrentParent != SensorNode::c_NoParentIndex)
-					{
-
-						if(m_SensorNodes[currentSN].m_CurrentParent != SensorNode::c_BaseStationIndex)
-						{
-							if (previousEvents[m_SensorNodes[currentSN].m_CurrentParent].State != WorkingState::Recovery)
-							{
-								m_SensorNodes[m_SensorNodes[currentSN].m_CurrentParent].m_CurrentData += m_SensorNodes[currentSN].m_CurrentData;
-								for (int i = 0; i < m_SensorNodes[currentSN].m_Packets.size(); i++)
-									m_SensorNodes[m_SensorNodes[currentSN].m_CurrentParent].m_Packets.push_back(m_SensorNodes[currentSN].m_Packets[i]);
-							}
-						}
-						else
-						{
-							transferredTotalDuration += m_SensorNodes[currentSN].m_CurrentData;
-							for (int i = 0; i < m_SensorNodes[currentSN].m_Packets.size(); i++)
-							{
-								m_SensorNodes[m_SensorNodes[currentSN].m_Packets[i].InitialSNID].m_SentPacketTotalDelay += currentTime - m_SensorNodes[currentSN].m_Packets[i].InitialTimestamp;
-								m_SensorNodes[m_SensorNodes[currentSN].m_Packets[i].InitialSNID].m_SentPacketCount++;
-
-								m_SensorNodes[m_SensorNodes[currentSN].m_Packets[i].InitialSNID].m_TotalDataSent += m_SensorNodes[currentSN].m_Packets[i].Size;
-							}
-						}
-
-						double distance = 0.0;
-						double posx = m_SensorNodes[currentSN].m_Position.X;
-						double posy = m_SensorNodes[currentSN].m_Position.X;
-						if (m_SensorNodes[currentSN].m_CurrentParent == SensorNode::c_BaseStationIndex)
-							distance = std::sqrt(posx * posx + posy * posy);
-						else
-							distance = SensorNode::Distance(m_SensorNodes[currentSN], m_SensorNodes[m_SensorNodes[currentSN].m_CurrentParent]);
-
-
-							
-						if (m_SensorNodes[currentSN].m_CurrentParent == SensorNode::c_BaseStationIndex || previousEvents[m_SensorNodes[currentSN].m_CurrentParent].State != WorkingState::Recovery)
-						{
-							m_SensorNodes[currentSN].m_Packets.clear();
-							m_SensorNodes[currentSN].m_CurrentData = 0;
-						}
-						m_SensorNodes[currentSN].m_EnergyConsumed += distance * distance * (currentTime - previousEvents[currentSN].Timestamp) * m_SimulatorParameters.EnergyRateTransfer + s_EnergyTransitionTransferToWorking;
-
-						m_SensorNodes[currentSN].m_WastedTime += m_SimulatorParameters.TransferTime;
-						m_SensorNodes[currentSN].m_Packets.push_back({ currentSN, currentTime });
-						m_SensorNodes[currentSN].m_CurrentPacketIterator = m_SensorNodes[currentSN].m_Packets.size() - 1;
-					}
-					else
-					{
-						m_SensorNodes[currentSN].m_Packets.clear();
-						m_SensorNodes[currentSN].m_CurrentData = 0;
-					}
-				}
-				else if (currentState == WorkingState::Transfer) {}
-				else if (currentState == WorkingState::Recovery)
-				{
-					m_SensorNodes[currentSN].m_WastedTime += currentTime - previousEvents[currentSN].Timestamp;
-					failureCount++;
-
-					{
-						for (int i = 0; i < m_SensorNodes[currentSN].m_Packets.size(); i++)
-						{
-							int energyCurrentSN = m_SensorNodes[currentSN].m_Packets[i].InitialSNID;
-							while (energyCurrentSN != currentSN)
-							{
-								double distance = SensorNode::Distance(m_SensorNodes[energyCurrentSN], m_SensorNodes[m_SensorNodes[energyCurrentSN].m_CurrentParent]);
-								m_SensorNodes[energyCurrentSN].m_EnergyWasted += m_SensorNodes[currentSN].m_Packets[i].Size * m_SimulatorParameters.EnergyRateSensing + s_EnergyTransitionWorkingToTransfer;
-								m_SensorNodes[energyCurrentSN].m_EnergyWasted += distance * distance * m_SimulatorParameters.TransferTime * m_SimulatorParameters.EnergyRateTransfer + s_EnergyTransitionTransferToWorking;
-
-								energyCurrentSN = m_SensorNodes[energyCurrentSN].m_CurrentParent;
-							}
-						}
-					}
-
-					double distance = 0.0;
-					double posx = m_SensorNodes[currentSN].m_Position.X;
-					double posy = m_SensorNodes[currentSN].m_Position.X;
-					if (m_SensorNodes[currentSN].m_CurrentParent == SensorNode::c_BaseStationIndex)
-						distance = std::sqrt(posx * posx + posy * posy);
-					else
-						distance = SensorNode::Distance(m_SensorNodes[currentSN], m_SensorNodes[m_SensorNodes[currentSN].m_CurrentParent]);
-					
-					m_SensorNodes[currentSN].m_EnergyConsumed += distance * distance * (currentTime - previousEvents[currentSN].Timestamp) * m_SimulatorParameters.EnergyRateTransfer + s_EnergyTransitionTransferToWorking;
-					m_SensorNodes[currentSN].m_EnergyWasted += distance * distance * (currentTime - previousEvents[currentSN].Timestamp) * m_SimulatorParameters.EnergyRateTransfer + s_EnergyTransitionTransferToWorking;
-
-					m_SensorNodes[currentSN].m_CurrentData = 0;
-					m_SensorNodes[currentSN].m_Packets.clear();
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = - 1;
-				}
-			}
-			else if (previousEvents[currentSN].State == WorkingState::Recovery)
-			{
+			nextState = WorkingState::Transfer;
+		}
+		else if (currentState == WorkingState::Transfer)
+		{
+			nextTime += m_SimulatorParameters.TransferTime;
+			nextState = WorkingState::Collection;
+		}
+		else if (currentState == WorkingState::Recovery)
+		{
+			nextTime += m_SimulatorParameters.RecoveryTime;
+			nextState = WorkingState::Collection;
+		}
 
-				if (currentState == WorkingState::Collection)
-				{
-					m_SensorNodes[currentSN].m_WastedTime += m_SimulatorParameters.RecoveryTime;
-					m_SensorNodes[currentSN].m_Packets.push_back({ currentSN, currentTime });
-					m_SensorNodes[currentSN].m_CurrentPacketIterator = m_SensorNodes[currentSN].m_Packets.size() - 1;
-					
-				}
-				else if (currentState == WorkingState::Transfer) {}
-				else if (currentState == WorkingState::Recovery)
-				{
-					m_SensorNodes[currentSN].m_WastedTime += currentTime - previousEvents[currentSN].Timestamp;
-					failureCount++;
-					m_SensorNodes[currentSN].m_CurrentData = 0;
-					m_SensorNodes[currentSN].m_Packets.clear();
-					m_SensorNodes[currentSN].m_CurrentPacketIterator =  - 1;
-				}
-			}
-
-			previousEvents[currentSN] = currentEvent;
-			
-
-
-			isDone = IsDone(currentTime);
+		if (failures.HasNext() && nextTime >= failures.Next())
+		{
+			double failureTime = failures.Next();
+			failures.Advance();
+			return { currentSN, WorkingState::Recovery, failureTime };
 		}
 
-		sr.ActualTotalDuration = currentTime;
-		sr.FinalFailureIndex = failureCount;
+		return { currentSN, nextState, nextTime };
+	}
+
+	WorkingState Simulator::ParentState(const WorkingStateTimestamp& event, int64_t parent, int colorCount, SimulationPartition* partition)
+	{
+		if (!partition || !partition->IsForeign(parent))
+			return m_SensorNodeTable.m_PreviousState[parent];
 
-		m_TransferredTotalDuration = transferredTotalDuration;
+		while (EventPrecedes(partition->m_ForeignParentEvent, event))
+		{
+			partition->m_ForeignParentState = partition->m_ForeignParentEvent.State;
+			partition->m_ForeignParentEvent = NextEvent(partition->m_ForeignParentEvent, colorCount, partition->m_ForeignParentFailures);
+		}
 
+		return partition->m_ForeignParentState;
 	}
 
 	bool Simulator::IsDone(double currentTime)
 	{
-		return currentTime >= m_SimulatorParameters.TotalSimulationTime;
+		return SimulationPolicyBase::IsDone(m_SimulatorParameters, currentTime);
 	}
 
 	void Simulator::Log()
@@ -520,6 +238,13 @@ namespace FaultNet_Sim
 	void Simulator::Deinitialize()
 	{
 		m_SensorNodes.clear();
+		m_TopologyCache.reset();
+		m_SpatialIndex.reset();
+		m_NeighborList.reset();
+		m_InterferenceGraph.reset();
+		m_RoutingTree.Clear();
+		m_SensorNodeTable.Clear();
+		m_PathCostTable.Clear();
 	}
 
 }
\ No newline at end of file
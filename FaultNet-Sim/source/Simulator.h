@@ -1,6 +1,14 @@
 #pragma once
 #include "Distribution.h"
 #include "SensorNode.h"
+#include "EventQueue.h"
+#include "SensorNodeTable.h"
+#include "PacketStore.h"
+#include "PathCostTable.h"
+#include "RoutingTree.h"
+#include "TopologyCache.h"
+#include "TreeSnapshot.h"
+#include "SimulationPartition.h"
 #include "DataInterface.h"
 
 namespace FaultNet_Sim
@@ -24,6 +32,7 @@ namespace FaultNet_Sim
 		double ActualTotalDuration = 0;
 		int64_t FinalFailureIndex = 0;
 		double CWSNEfficiency = 0;
+		int64_t ColorCount = 0;
 	};
 
 	struct SimulatorParameters
@@ -39,6 +48,32 @@ namespace FaultNet_Sim
 		double InterferenceRange;
 	};
 
+	enum class SimulationEngineType
+	{
+		EventDriven = 0,
+		FastForward,
+		SlotSynchronous,
+		Parallel
+	};
+
+	std::string SimulationEngineTypeToString(const SimulationEngineType& set);
+
+	struct SimulatorOptions
+	{
+		EventQueueType EventQueue = EventQueueType::Tournament;
+		PacketAccountingType PacketAccounting = PacketAccountingType::Exact;
+		LossChargingType LossCharging = LossChargingType::PerPacket;
+		SimulationEngineType Engine = SimulationEngineType::EventDriven;
+		ColoringType Coloring = ColoringType::WelshPowell;
+		uint64_t ColoringSeed = 0;
+		// Reuses the topology and colors constructed by another simulator of the problem of the
+		// same type, ranges and coloring, which assumes ConstructTopology and ColorTopology only
+		// depend on those.
+		bool CacheTopology = true;
+		// Workers of the Parallel engine and of JonesPlassmann coloring, 0 uses one per hardware thread.
+		int ThreadCount = 0;
+	};
+
 	struct SimulatorParameterGrid
 	{
 		std::vector<double> TotalSimulationTime;
@@ -59,7 +94,8 @@ namespace FaultNet_Sim
 		Simulator(SimulatorParameters sp, std::string description = "");
 		Simulator(const Simulator& other);
 
-		void Run(int64_t problemID, const std::vector<SensorNode>& SNs);
+		// A topology cache of SNs is created when none is given.
+		void Run(int64_t problemID, const std::vector<SensorNode>& SNs, std::shared_ptr<TopologyCache> topologyCache = nullptr);
 
 		virtual std::shared_ptr<Simulator> Clone() const
 		{
@@ -124,7 +160,11 @@ namespace FaultNet_Sim
 		inline std::string GetDescription() { return m_Description; }
 		inline SimulatorParameters GetSimulatorParameters() { return m_SimulatorParameters; }
 		inline SimulatorResults GetSimulatorResults() { return m_SimulatorResults; }
+		inline SimulatorOptions GetSimulatorOptions() { return m_SimulatorOptions; }
+		inline void SetSimulatorOptions(SimulatorOptions so) { m_SimulatorOptions = so; }
 		inline double GetTransferredTotalDuration() { return m_TransferredTotalDuration; }
+		inline const InterferenceGraph& GetInterferenceGraph() { return *m_InterferenceGraph; }
+		inline const RoutingTree& GetRoutingTree() { return m_RoutingTree; }
 
 	protected:
 		Simulator() = delete;
@@ -147,14 +187,61 @@ namespace FaultNet_Sim
 		double m_TransferredTotalDuration;
 
 		std::vector<SensorNode> m_SensorNodes;
+		std::shared_ptr<TopologyCache> m_TopologyCache;
+		std::shared_ptr<const SpatialIndex> m_SpatialIndex;
+		std::shared_ptr<const NeighborList> m_NeighborList;
+		std::shared_ptr<const InterferenceGraph> m_InterferenceGraph;
+		RoutingTree m_RoutingTree;
+		SensorNodeTable m_SensorNodeTable;
+		PathCostTable m_PathCostTable;
 
 		SimulatorParameters m_SimulatorParameters;
 
 		SimulatorResults m_SimulatorResults;
 
+		SimulatorOptions m_SimulatorOptions;
+
 		static int64_t GenerateID();
 
+		// Runs the simulation loop selected by the options with the customization points of policy.
+		template<typename TPolicy>
+		void SimulateWithPolicy(TPolicy& policy);
+
 	private:
+		friend class VirtualSimulationPolicy;
+
+		template<typename TPolicy, typename TPacketStore>
+		void SimulateWithPacketStore(TPolicy& policy, TPacketStore& packetStore, int colorCount);
+
+		template<typename TPolicy, typename TEventQueue, typename TPacketStore>
+		void SimulateEvents(TPolicy& policy, TEventQueue& eventQueue, TPacketStore& packetStore, int colorCount);
+
+		template<typename TPolicy, typename TPacketStore>
+		void SimulateFastForward(TPolicy& policy, TPacketStore& packetStore, int colorCount);
+
+		template<typename TPolicy, typename TPacketStore>
+		void SimulateSlotSynchronous(TPolicy& policy, TPacketStore& packetStore, int colorCount);
+
+		template<typename TPolicy, typename TPacketStore>
+		void SimulateParallel(TPolicy& policy, TPacketStore& packetStore, int colorCount);
+
+		template<typename TPolicy, typename TPacketStore>
+		void SimulateWindow(TPolicy& policy, SimulationPartition& partition, std::vector<SimulationPartition>& partitions, TPacketStore& packetStore, int colorCount, double windowEnd);
+
+		int64_t SkippablePeriods(const std::vector<int64_t>& tree, const std::vector<WorkingStateTimestamp>& pendingEvents, double period);
+
+		template<typename TPolicy>
+		int64_t PeriodsBeforeDone(TPolicy& policy, double boundary, double period, int64_t periods);
+
+		// The transition that follows currentEvent for its SN, which only depends on the SN itself.
+		WorkingStateTimestamp NextEvent(const WorkingStateTimestamp& currentEvent, int colorCount, FailureStream& failures) const;
+
+		// State the parent of an SN was left in by the transitions preceding event.
+		WorkingState ParentState(const WorkingStateTimestamp& event, int64_t parent, int colorCount, SimulationPartition* partition);
+
+		// Hands the transition to the handler of the policy and returns the next event of the SN.
+		template<typename TPolicy, typename TPacketStore>
+		WorkingStateTimestamp ProcessEvent(TPolicy& policy, const WorkingStateTimestamp& currentEvent, TPacketStore& packetStore, int colorCount, double& transferredTotalDuration, int& failureCount, SimulationPartition* partition = nullptr);
 
 		void Log();
 
@@ -0,0 +1,707 @@
+#pragma once
+#include "Simulator.h"
+#include "SimulationPolicy.h"
+
+// Definitions of the simulation loops of Simulator. They are templates on the policy whose
+// members they call, so they live in a header for PolicySimulator to compile them for any policy.
+namespace FaultNet_Sim
+{
+	template<typename TPolicy>
+	void Simulator::SimulateWithPolicy(TPolicy& policy)
+	{
+		m_SensorNodeTable.Load(m_SensorNodes);
+
+		int colorCount = -1;
+		for (int i = 0; i < m_SensorNodes.size(); i++)
+			colorCount = std::max(colorCount, (int)m_SensorNodes[i].m_Color);
+		colorCount++;
+
+		switch (m_SimulatorOptions.PacketAccounting)
+		{
+		case PacketAccountingType::Exact:
+		{
+			ExactPacketStore packetStore(m_SensorNodeTable);
+			SimulateWithPacketStore(policy, packetStore, colorCount);
+			break;
+		}
+		case PacketAccountingType::Aggregated:
+		{
+			AggregatedPacketStore packetStore(m_SensorNodeTable.Size());
+			SimulateWithPacketStore(policy, packetStore, colorCount);
+			break;
+		}
+		case PacketAccountingType::Pooled:
+		{
+			PooledPacketStore packetStore(m_SensorNodeTable.Size());
+			SimulateWithPacketStore(policy, packetStore, colorCount);
+			break;
+		}
+		default:
+			throw std::runtime_error("Unknown Packet Accounting Type in Simulator::SimulateWithPolicy");
+		}
+
+		m_SensorNodeTable.Store(m_SensorNodes);
+	}
+
+	template<typename TPolicy, typename TPacketStore>
+	void Simulator::SimulateWithPacketStore(TPolicy& policy, TPacketStore& packetStore, int colorCount)
+	{
+		if (m_SimulatorOptions.Engine == SimulationEngineType::FastForward)
+		{
+			SimulateFastForward(policy, packetStore, colorCount);
+			return;
+		}
+		else if (m_SimulatorOptions.Engine == SimulationEngineType::SlotSynchronous && colorCount > 0)
+		{
+			SimulateSlotSynchronous(policy, packetStore, colorCount);
+			return;
+		}
+		else if (m_SimulatorOptions.Engine == SimulationEngineType::Parallel && colorCount > 0)
+		{
+			// The packet pool is shared by all SNs, so partitions keep their packets in the table instead.
+			if constexpr (std::is_same_v<TPacketStore, PooledPacketStore>)
+			{
+				ExactPacketStore exactPacketStore(m_SensorNodeTable);
+				SimulateParallel(policy, exactPacketStore, colorCount);
+			}
+			else
+				SimulateParallel(policy, packetStore, colorCount);
+			return;
+		}
+
+		switch (m_SimulatorOptions.EventQueue)
+		{
+		case EventQueueType::BinaryHeap:
+		{
+			BinaryHeapEventQueue eventQueue;
+			SimulateEvents(policy, eventQueue, packetStore, colorCount);
+			break;
+		}
+		case EventQueueType::CalendarQueue:
+		{
+			// Every pending event lies at most one delta plus two superslots (or one recovery) ahead.
+			double maxDelta = 0.0;
+			for (int i = 0; i < m_SensorNodeTable.Size(); i++)
+				maxDelta = std::max(maxDelta, m_SensorNodeTable.m_DeltaOpt[i]);
+			double horizon = std::max(maxDelta + 2 * m_SimulatorParameters.TransferTime * colorCount, m_SimulatorParameters.RecoveryTime) + m_SimulatorParameters.TransferTime;
+
+			CalendarEventQueue eventQueue(m_SimulatorParameters.TransferTime, horizon);
+			SimulateEvents(policy, eventQueue, packetStore, colorCount);
+			break;
+		}
+		case EventQueueType::Tournament:
+		{
+			TournamentEventQueue eventQueue(m_SensorNodeTable.Size());
+			SimulateEvents(policy, eventQueue, packetStore, colorCount);
+			break;
+		}
+		default:
+			throw std::runtime_error("Unknown Event Queue Type in Simulator::Simulate");
+		}
+	}
+
+	template<typename TPolicy, typename TEventQueue, typename TPacketStore>
+	void Simulator::SimulateEvents(TPolicy& policy, TEventQueue& eventQueue, TPacketStore& packetStore, int colorCount)
+	{
+		SimulatorResults& sr = m_SimulatorResults;
+		SensorNodeTable& snt = m_SensorNodeTable;
+
+		for (int i = 0; i < snt.Size(); i++)
+		{
+			if(snt.m_CurrentParent[i] == SensorNode::c_NoParentIndex)
+				continue;
+			eventQueue.Push({ (int64_t)i, WorkingState::Collection, 0.0 });
+		}
+
+		double transferredTotalDuration = 0;
+		double currentTime = 0.0;
+		int failureCount = 0;
+
+		bool isDone = false;
+
+		while (!isDone && !eventQueue.Empty())
+		{
+			auto currentEvent = eventQueue.Top();
+			currentTime = currentEvent.Timestamp;
+			eventQueue.Pop();
+
+			eventQueue.Push(ProcessEvent(policy, currentEvent, packetStore, colorCount, transferredTotalDuration, failureCount));
+
+			isDone = policy.IsDone(m_SimulatorParameters, currentTime);
+		}
+
+		sr.ActualTotalDuration = currentTime;
+		sr.FinalFailureIndex = failureCount;
+
+		m_TransferredTotalDuration = transferredTotalDuration;
+
+	}
+
+	template<typename TPolicy, typename TPacketStore>
+	void Simulator::SimulateFastForward(TPolicy& policy, TPacketStore& packetStore, int colorCount)
+	{
+		SimulatorResults& sr = m_SimulatorResults;
+		SensorNodeTable& snt = m_SensorNodeTable;
+
+		double period = m_SimulatorParameters.TransferTime * colorCount;
+
+		std::vector<WorkingStateTimestamp> pendingEvents(snt.Size());
+		for (int i = 0; i < snt.Size(); i++)
+			pendingEvents[i] = { (int64_t)i, WorkingState::Collection, 0.0 };
+
+		double transferredTotalDuration = 0;
+		double currentTime = 0.0;
+		int failureCount = 0;
+
+		bool hasStopEvent = false;
+		WorkingStateTimestamp stopEvent;
+
+		// Routing trees never exchange data, so each one runs on its own up to the
+		// first event that satisfies IsDone.
+		for (const std::vector<int64_t>& tree : snt.RoutingTrees())
+		{
+			BinaryHeapEventQueue eventQueue;
+			for (int64_t sn : tree)
+			{
+				if (snt.m_CurrentParent[sn] != SensorNode::c_NoParentIndex)
+					eventQueue.Push(pendingEvents[sn]);
+			}
+
+			TreeAccumulators accumulators(tree.size());
+			TreeSnapshot previousSnapshot;
+			TreeSnapshot currentSnapshot;
+			bool hasPreviousSnapshot = false;
+
+			double periodTransferredDuration = 0;
+			int periodFailureCount = 0;
+			double boundary = period;
+
+			while (!eventQueue.Empty())
+			{
+				WorkingStateTimestamp currentEvent = eventQueue.Top();
+
+				if (policy.IsDone(m_SimulatorParameters, currentEvent.Timestamp))
+				{
+					if (!hasStopEvent || EventPrecedes(currentEvent, stopEvent))
+						stopEvent = currentEvent;
+					hasStopEvent = true;
+					break;
+				}
+
+				// Snapshots are only worth taking while no SN of the tree is about to fail.
+				if (currentEvent.Timestamp >= boundary)
+				{
+					int64_t skippablePeriods = SkippablePeriods(tree, pendingEvents, period);
+					if (skippablePeriods <= 0)
+					{
+						hasPreviousSnapshot = false;
+						boundary += period;
+						continue;
+					}
+
+					currentSnapshot.Capture(tree, snt, pendingEvents, packetStore, boundary);
+
+					int64_t repetitions = 1;
+					if (hasPreviousSnapshot && currentSnapshot == previousSnapshot)
+					{
+						skippablePeriods = PeriodsBeforeDone(policy, boundary, period, skippablePeriods);
+						if (skippablePeriods > 0)
+						{
+							double offset = skippablePeriods * period;
+							eventQueue = BinaryHeapEventQueue();
+							for (int64_t sn : tree)
+							{
+								snt.m_PreviousTimestamp[sn] += offset;
+								packetStore.Shift(sn, offset);
+								if (snt.m_CurrentParent[sn] != SensorNode::c_NoParentIndex)
+								{
+									pendingEvents[sn].Timestamp += offset;
+									eventQueue.Push(pendingEvents[sn]);
+								}
+							}
+
+							boundary += offset;
+							repetitions += skippablePeriods;
+						}
+					}
+
+					accumulators.Fold(tree, snt, repetitions);
+					transferredTotalDuration += repetitions * periodTransferredDuration;
+					failureCount += repetitions * periodFailureCount;
+					periodTransferredDuration = 0;
+					periodFailureCount = 0;
+
+					std::swap(previousSnapshot, currentSnapshot);
+					hasPreviousSnapshot = true;
+					boundary += period;
+					continue;
+				}
+
+				eventQueue.Pop();
+				currentTime = std::max(currentTime, currentEvent.Timestamp);
+
+				pendingEvents[currentEvent.SNID] = ProcessEvent(policy, currentEvent, packetStore, colorCount, periodTransferredDuration, periodFailureCount);
+				eventQueue.Push(pendingEvents[currentEvent.SNID]);
+			}
+
+			accumulators.Restore(tree, snt);
+			transferredTotalDuration += periodTransferredDuration;
+			failureCount += periodFailureCount;
+		}
+
+		if (hasStopEvent)
+		{
+			currentTime = stopEvent.Timestamp;
+			ProcessEvent(policy, stopEvent, packetStore, colorCount, transferredTotalDuration, failureCount);
+		}
+
+		sr.ActualTotalDuration = currentTime;
+		sr.FinalFailureIndex = failureCount;
+
+		m_TransferredTotalDuration = transferredTotalDuration;
+	}
+
+	template<typename TPolicy, typename TPacketStore>
+	void Simulator::SimulateSlotSynchronous(TPolicy& policy, TPacketStore& packetStore, int colorCount)
+	{
+		SimulatorResults& sr = m_SimulatorResults;
+		SensorNodeTable& snt = m_SensorNodeTable;
+
+		double transferTime = m_SimulatorParameters.TransferTime;
+		auto colorOfSlot = [colorCount](int64_t slot) { return (int)(((slot % colorCount) + colorCount) % colorCount); };
+
+		// SNs of every color in descending SNID order, the order in which simultaneous transitions are processed.
+		std::vector<std::vector<int64_t>> colorSNs(colorCount);
+		int64_t activeCount = 0;
+		for (int64_t i = snt.Size() - 1; i >= 0; i--)
+		{
+			colorSNs[colorOfSlot(snt.m_CurrentColor[i])].push_back(i);
+			if (snt.m_CurrentParent[i] != SensorNode::c_NoParentIndex)
+				activeCount++;
+		}
+
+		// Transfers and the collections that follow them sit on the TDMA slot grid and are
+		// found by scanning the SNs of the slot's color, everything else waits in a heap.
+		std::vector<WorkingStateTimestamp> pendingEvents(snt.Size());
+		std::vector<char> isSlotEvent(snt.Size(), false);
+		BinaryHeapEventQueue eventQueue;
+
+		double transferredTotalDuration = 0;
+		double currentTime = 0.0;
+		int failureCount = 0;
+
+		bool isDone = false;
+
+		auto schedule = [&](const WorkingStateTimestamp& event, WorkingState previousState)
+		{
+			// A transfer always starts in a slot of the SN's own color, so an exact match with the grid is
+			// enough, and the collection that follows is on the grid whenever the transfer was.
+			bool onSlot = false;
+			if (event.State == WorkingState::Transfer)
+			{
+				int64_t slot = std::llround(event.Timestamp / transferTime);
+				onSlot = slot * transferTime == event.Timestamp;
+			}
+			else if (event.State == WorkingState::Collection && previousState == WorkingState::Transfer)
+				onSlot = isSlotEvent[event.SNID];
+
+			pendingEvents[event.SNID] = event;
+			isSlotEvent[event.SNID] = onSlot;
+			if (!onSlot)
+				eventQueue.Push(event);
+		};
+
+		auto process = [&](WorkingStateTimestamp event)
+		{
+			// A transition scheduled at the current timestamp is processed right away, since its SN has the largest SNID left.
+			while (true)
+			{
+				currentTime = event.Timestamp;
+				WorkingStateTimestamp nextEvent = ProcessEvent(policy, event, packetStore, colorCount, transferredTotalDuration, failureCount);
+
+				isDone = policy.IsDone(m_SimulatorParameters, currentTime);
+				if (isDone)
+					return;
+
+				if (nextEvent.Timestamp != currentTime)
+				{
+					schedule(nextEvent, event.State);
+					return;
+				}
+				event = nextEvent;
+			}
+		};
+
+		auto processUntil = [&](double timestamp)
+		{
+			while (!isDone && !eventQueue.Empty() && eventQueue.Top().Timestamp < timestamp)
+			{
+				WorkingStateTimestamp event = eventQueue.Top();
+				eventQueue.Pop();
+				process(event);
+			}
+		};
+
+		std::vector<WorkingStateTimestamp> heapEvents;
+		auto processSlot = [&](double timestamp, const std::vector<int64_t>* endSNs, const std::vector<int64_t>* startSNs)
+		{
+			heapEvents.clear();
+			while (!eventQueue.Empty() && eventQueue.Top().Timestamp == timestamp)
+			{
+				heapEvents.push_back(eventQueue.Top());
+				eventQueue.Pop();
+			}
+
+			auto isPending = [&](int64_t sn, WorkingState state)
+			{
+				return isSlotEvent[sn] && pendingEvents[sn].State == state && pendingEvents[sn].Timestamp == timestamp;
+			};
+
+			size_t endIndex = 0;
+			size_t startIndex = 0;
+			size_t heapIndex = 0;
+			while (!isDone)
+			{
+				while (endSNs && endIndex < endSNs->size() && !isPending((*endSNs)[endIndex], WorkingState::Collection))
+					endIndex++;
+				while (startSNs && startIndex < startSNs->size() && !isPending((*startSNs)[startIndex], WorkingState::Transfer))
+					startIndex++;
+
+				int64_t endSN = endSNs && endIndex < endSNs->size() ? (*endSNs)[endIndex] : -1;
+				int64_t startSN = startSNs && startIndex < startSNs->size() ? (*startSNs)[startIndex] : -1;
+				int64_t heapSN = heapIndex < heapEvents.size() ? heapEvents[heapIndex].SNID : -1;
+
+				if (endSN < 0 && startSN < 0 && heapSN < 0)
+					break;
+
+				if (heapSN > endSN && heapSN > startSN)
+					process(heapEvents[heapIndex++]);
+				else if (endSN > startSN)
+				{
+					endIndex++;
+					process(pendingEvents[endSN]);
+				}
+				else
+				{
+					startIndex++;
+					process(pendingEvents[startSN]);
+				}
+			}
+		};
+
+		for (int i = 0; i < snt.Size(); i++)
+		{
+			if (snt.m_CurrentParent[i] == SensorNode::c_NoParentIndex)
+				continue;
+			schedule({ (int64_t)i, WorkingState::Collection, 0.0 }, WorkingState::Collection);
+		}
+
+		for (int64_t slot = 0; !isDone && activeCount > 0; slot++)
+		{
+			double endTime = (slot - 1) * transferTime + transferTime;
+			double startTime = slot * transferTime;
+			const std::vector<int64_t>& endSNs = colorSNs[colorOfSlot(slot - 1)];
+			const std::vector<int64_t>& startSNs = colorSNs[colorOfSlot(slot)];
+
+			if (endTime == startTime)
+			{
+				processUntil(startTime);
+				if (!isDone)
+					processSlot(startTime, &endSNs, &startSNs);
+			}
+			else if (endTime < startTime)
+			{
+				processUntil(endTime);
+				if (!isDone)
+					processSlot(endTime, &endSNs, nullptr);
+				processUntil(startTime);
+				if (!isDone)
+					processSlot(startTime, nullptr, &startSNs);
+			}
+			else
+			{
+				processUntil(startTime);
+				if (!isDone)
+					processSlot(startTime, nullptr, &startSNs);
+				processUntil(endTime);
+				if (!isDone)
+					processSlot(endTime, &endSNs, nullptr);
+			}
+		}
+
+		sr.ActualTotalDuration = currentTime;
+		sr.FinalFailureIndex = failureCount;
+
+		m_TransferredTotalDuration = transferredTotalDuration;
+	}
+
+	template<typename TPolicy, typename TPacketStore>
+	void Simulator::SimulateParallel(TPolicy& policy, TPacketStore& packetStore, int colorCount)
+	{
+		SimulatorResults& sr = m_SimulatorResults;
+		SensorNodeTable& snt = m_SensorNodeTable;
+
+		int64_t activeCount = 0;
+		for (int i = 0; i < snt.Size(); i++)
+		{
+			if (snt.m_CurrentParent[i] != SensorNode::c_NoParentIndex)
+				activeCount++;
+		}
+
+		size_t threadCount = m_SimulatorOptions.ThreadCount > 0 ? m_SimulatorOptions.ThreadCount : std::max(1u, std::thread::hardware_concurrency());
+
+		// A few partitions per worker, so that the workers stay balanced while the partitions move through the pipeline.
+		std::vector<int64_t> partitionOf(snt.Size(), -1);
+		std::vector<SimulationPartition> partitions;
+		for (std::vector<int64_t>& subtree : snt.RoutingSubtrees(std::max<size_t>(1, activeCount / (threadCount * 4))))
+		{
+			for (int64_t sn : subtree)
+				partitionOf[sn] = partitions.size();
+			partitions.emplace_back(partitions.size(), std::move(subtree), partitionOf);
+		}
+
+		for (SimulationPartition& partition : partitions)
+		{
+			partition.Link(partitions, snt);
+			for (int64_t sn : partition.m_SNs)
+			{
+				if (snt.m_CurrentParent[sn] != SensorNode::c_NoParentIndex)
+					partition.m_EventQueue.Push({ sn, WorkingState::Collection, 0.0 });
+			}
+		}
+
+		// Parent partitions come before their children, and every partition runs one window behind its slowest child.
+		int64_t maxHeight = 0;
+		for (auto it = partitions.rbegin(); it != partitions.rend(); it++)
+		{
+			if (it->m_ParentPartition >= 0)
+				partitions[it->m_ParentPartition].m_Height = std::max(partitions[it->m_ParentPartition].m_Height, it->m_Height + 1);
+			maxHeight = std::max(maxHeight, it->m_Height);
+		}
+
+		std::vector<std::vector<int64_t>> workerPartitions(std::min(threadCount, std::max<size_t>(1, partitions.size())));
+		{
+			std::vector<int64_t> order(partitions.size());
+			for (int i = 0; i < order.size(); i++)
+				order[i] = i;
+			std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) { return partitions[a].m_SNs.size() > partitions[b].m_SNs.size(); });
+
+			std::vector<size_t> workerLoad(workerPartitions.size(), 0);
+			for (int64_t partition : order)
+			{
+				size_t worker = std::min_element(workerLoad.begin(), workerLoad.end()) - workerLoad.begin();
+				workerPartitions[worker].push_back(partition);
+				workerLoad[worker] += partitions[partition].m_SNs.size();
+			}
+		}
+
+		// An SN transfers at most once per superslot, so a superslot is the window of simulated time
+		// that a partition runs before its parent partition needs what it sent.
+		double windowLength = m_SimulatorParameters.TransferTime * colorCount;
+		size_t outboxSize = maxHeight + 2;
+
+		int64_t step = 0;
+		bool isFinished = partitions.empty();
+
+		auto completeStep = [&]() noexcept
+		{
+			isFinished = true;
+			for (auto it = partitions.rbegin(); it != partitions.rend(); it++)
+			{
+				SimulationPartition& partition = *it;
+				int64_t window = step - partition.m_Height;
+				if (!partition.m_IsFinished && window >= 0 && (partition.m_HasStopEvent || partition.m_EventQueue.Empty()))
+				{
+					bool isDrained = true;
+					for (int64_t child : partition.m_ChildPartitions)
+						isDrained = isDrained && partitions[child].m_IsFinished && partitions[child].m_FinalWindow <= window;
+
+					if (isDrained)
+					{
+						partition.m_IsFinished = true;
+						partition.m_FinalWindow = window;
+					}
+				}
+
+				isFinished = isFinished && partition.m_IsFinished;
+			}
+
+			step++;
+		};
+
+		std::barrier barrier(workerPartitions.size(), completeStep);
+
+		auto work = [&](const std::vector<int64_t>& owned)
+		{
+			for (int64_t currentStep = 0; !isFinished; currentStep++)
+			{
+				for (int64_t index : owned)
+				{
+					SimulationPartition& partition = partitions[index];
+					int64_t window = currentStep - partition.m_Height;
+					if (window < 0 || partition.m_IsFinished)
+						continue;
+
+					partition.BeginWindow(window, outboxSize);
+					SimulateWindow(policy, partition, partitions, packetStore, colorCount, (window + 1) * windowLength);
+				}
+
+				barrier.arrive_and_wait();
+			}
+		};
+
+		{
+			std::vector<std::thread> workers;
+			for (int i = 1; i < workerPartitions.size(); i++)
+				workers.emplace_back(work, std::cref(workerPartitions[i]));
+			work(workerPartitions[0]);
+
+			for (std::thread& worker : workers)
+				worker.join();
+		}
+
+		double transferredTotalDuration = 0;
+		double currentTime = 0.0;
+		int failureCount = 0;
+
+		bool hasStopEvent = false;
+		WorkingStateTimestamp stopEvent;
+
+		for (SimulationPartition& partition : partitions)
+		{
+			transferredTotalDuration += partition.m_TransferredTotalDuration;
+			failureCount += partition.m_FailureCount;
+			currentTime = std::max(currentTime, partition.m_CurrentTime);
+
+			for (const auto& [sn, energyWasted] : partition.m_ForeignEnergyWasted)
+				snt.m_EnergyWasted[sn] += energyWasted;
+
+			if (partition.m_HasStopEvent && (!hasStopEvent || EventPrecedes(partition.m_StopEvent, stopEvent)))
+			{
+				stopEvent = partition.m_StopEvent;
+				hasStopEvent = true;
+			}
+		}
+
+		// Every transition before the first one that satisfies IsDone has been processed, so it sees the whole table.
+		if (hasStopEvent)
+		{
+			currentTime = stopEvent.Timestamp;
+			ProcessEvent(policy, stopEvent, packetStore, colorCount, transferredTotalDuration, failureCount);
+		}
+
+		sr.ActualTotalDuration = currentTime;
+		sr.FinalFailureIndex = failureCount;
+
+		m_TransferredTotalDuration = transferredTotalDuration;
+	}
+
+	template<typename TPolicy, typename TPacketStore>
+	void Simulator::SimulateWindow(TPolicy& policy, SimulationPartition& partition, std::vector<SimulationPartition>& partitions, TPacketStore& packetStore, int colorCount, double windowEnd)
+	{
+		SensorNodeTable& snt = m_SensorNodeTable;
+		BinaryHeapEventQueue& eventQueue = partition.m_EventQueue;
+
+		partition.GatherMessages(partitions);
+
+		// Transfers from the child partitions are interleaved with the partition's own transitions in event order.
+		size_t messageIndex = 0;
+		while (true)
+		{
+			bool hasEvent = !partition.m_HasStopEvent && !eventQueue.Empty() && eventQueue.Top().Timestamp < windowEnd;
+
+			if (messageIndex < partition.m_Inbox.size() && (!hasEvent || EventPrecedes(partition.m_Inbox[messageIndex].Event, eventQueue.Top())))
+			{
+				const ForwardMessage& message = partition.m_Inbox[messageIndex++];
+				snt.m_CurrentData[message.Destination] += message.Data;
+				for (size_t i = message.BatchBegin; i < message.BatchEnd; i++)
+					packetStore.Receive(message.Destination, (*message.Batches)[i]);
+				continue;
+			}
+
+			if (!hasEvent)
+				break;
+
+			WorkingStateTimestamp currentEvent = eventQueue.Top();
+			if (policy.IsDone(m_SimulatorParameters, currentEvent.Timestamp))
+			{
+				partition.m_HasStopEvent = true;
+				partition.m_StopEvent = currentEvent;
+				continue;
+			}
+
+			eventQueue.Pop();
+			partition.m_CurrentTime = currentEvent.Timestamp;
+			eventQueue.Push(ProcessEvent(policy, currentEvent, packetStore, colorCount, partition.m_TransferredTotalDuration, partition.m_FailureCount, &partition));
+		}
+	}
+
+	template<typename TPolicy>
+	int64_t Simulator::PeriodsBeforeDone(TPolicy& policy, double boundary, double period, int64_t periods)
+	{
+		// IsDone is assumed to be monotone in time, so the skipped superslots have to end before it holds.
+		if (!policy.IsDone(m_SimulatorParameters, boundary + periods * period))
+			return periods;
+
+		int64_t low = 0;
+		int64_t high = periods;
+		while (high - low > 1)
+		{
+			int64_t middle = low + (high - low) / 2;
+			if (policy.IsDone(m_SimulatorParameters, boundary + middle * period))
+				high = middle;
+			else
+				low = middle;
+		}
+
+		return low;
+	}
+
+	template<typename TPolicy, typename TPacketStore>
+	WorkingStateTimestamp Simulator::ProcessEvent(TPolicy& policy, const WorkingStateTimestamp& currentEvent, TPacketStore& packetStore, int colorCount, double& transferredTotalDuration, int& failureCount, SimulationPartition* partition)
+	{
+		SensorNodeTable& snt = m_SensorNodeTable;
+
+		const WorkingState& currentState = currentEvent.State;
+		const int64_t& currentSN = currentEvent.SNID;
+
+		if (!snt.HasNextFailure(currentSN))
+			std::cout << "Ran out of failures!\n";
+		WorkingStateTimestamp nextEvent = NextEvent(currentEvent, colorCount, snt.m_Failures[currentSN]);
+
+		TransitionContext context = { snt, m_SimulatorParameters, m_SimulatorOptions, m_PathCostTable, snt.m_PreviousTimestamp[currentSN], transferredTotalDuration, failureCount, partition };
+
+		if (snt.m_PreviousState[currentSN] == WorkingState::Collection)
+		{
+			if (currentState == WorkingState::Collection)
+				policy.OnCollectionToCollection(context, currentEvent, packetStore);
+			else if (currentState == WorkingState::Transfer)
+				policy.OnCollectionToTransfer(context, currentEvent, packetStore);
+			else if (currentState == WorkingState::Recovery)
+				policy.OnCollectionToRecovery(context, currentEvent, packetStore);
+		}
+		else if (snt.m_PreviousState[currentSN] == WorkingState::Transfer)
+		{
+			if (currentState == WorkingState::Collection)
+			{
+				int64_t currentParent = snt.m_CurrentParent[currentSN];
+				WorkingState parentState = currentParent >= 0 ? ParentState(currentEvent, currentParent, colorCount, partition) : WorkingState::Collection;
+				policy.OnTransferToCollection(context, currentEvent, packetStore, parentState);
+			}
+			else if (currentState == WorkingState::Recovery)
+				policy.OnTransferToRecovery(context, currentEvent, packetStore);
+		}
+		else if (snt.m_PreviousState[currentSN] == WorkingState::Recovery)
+		{
+			if (currentState == WorkingState::Collection)
+				policy.OnRecoveryToCollection(context, currentEvent, packetStore);
+			else if (currentState == WorkingState::Recovery)
+				policy.OnRecoveryToRecovery(context, currentEvent, packetStore);
+		}
+
+		snt.m_PreviousState[currentSN] = currentState;
+		snt.m_PreviousTimestamp[currentSN] = currentEvent.Timestamp;
+
+		return nextEvent;
+	}
+}
@@ -0,0 +1,56 @@
+#include "PCH.h"
+#include "SpatialIndex.h"
+
+namespace FaultNet_Sim
+{
+	SpatialIndex::SpatialIndex(const std::vector<SensorNode>& SNs)
+	{
+		if (SNs.empty())
+			return;
+
+		m_X.resize(SNs.size());
+		m_Y.resize(SNs.size());
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			m_X[i] = SNs[i].m_Position.X;
+			m_Y[i] = SNs[i].m_Position.Y;
+		}
+
+		m_MinX = *std::min_element(m_X.begin(), m_X.end());
+		m_MinY = *std::min_element(m_Y.begin(), m_Y.end());
+		double width = *std::max_element(m_X.begin(), m_X.end()) - m_MinX;
+		double height = *std::max_element(m_Y.begin(), m_Y.end()) - m_MinY;
+
+		// The second bound keeps the cell count linear when the SNs lie on a line.
+		m_CellSize = std::max(std::sqrt(width * height / SNs.size()), std::max(width, height) / SNs.size());
+		if (m_CellSize <= 0.0)
+			m_CellSize = 1.0;
+
+		m_Columns = (int64_t)std::floor(width / m_CellSize) + 1;
+		m_Rows = (int64_t)std::floor(height / m_CellSize) + 1;
+
+		std::vector<int64_t> cells(SNs.size());
+		m_CellStart.assign(m_Columns * m_Rows + 1, 0);
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			cells[i] = Row(m_Y[i]) * m_Columns + Column(m_X[i]);
+			m_CellStart[cells[i] + 1]++;
+		}
+
+		for (int64_t cell = 0; cell < m_Columns * m_Rows; cell++)
+			m_CellStart[cell + 1] += m_CellStart[cell];
+
+		std::vector<int64_t> next(m_CellStart.begin(), m_CellStart.end() - 1);
+		m_CellSNs.resize(SNs.size());
+		for (int i = 0; i < SNs.size(); i++)
+			m_CellSNs[next[cells[i]]++] = i;
+
+		m_CellX.resize(SNs.size());
+		m_CellY.resize(SNs.size());
+		for (int64_t k = 0; k < m_CellSNs.size(); k++)
+		{
+			m_CellX[k] = m_X[m_CellSNs[k]];
+			m_CellY[k] = m_Y[m_CellSNs[k]];
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "SensorNode.h"
+
+namespace FaultNet_Sim
+{
+	// Uniform grid over the SN positions with about one SN per cell. It does not depend
+	// on any range, so a problem builds it once and every simulator queries it with its
+	// own TransmissionRange.
+	class SpatialIndex
+	{
+	public:
+		SpatialIndex(const std::vector<SensorNode>& SNs);
+
+		inline size_t Size() const { return m_X.size(); }
+		inline double X(int64_t sn) const { return m_X[sn]; }
+		inline double Y(int64_t sn) const { return m_Y[sn]; }
+
+		inline double Distance(int64_t a, int64_t b) const
+		{
+			return std::sqrt(
+				(m_X[a] - m_X[b]) * (m_X[a] - m_X[b]) +
+				(m_Y[a] - m_Y[b]) * (m_Y[a] - m_Y[b])
+			);
+		}
+
+		// Visits the SNs of every cell overlapping the square of side 2 * radius centered
+		// on (x, y), which includes every SN within radius, one cell after another.
+		template<typename TFunction>
+		inline void ForEachCandidate(double x, double y, double radius, TFunction function) const
+		{
+			ForEachCandidateRun(x, y, radius, [&](const int64_t* SNs, const double* xs, const double* ys, size_t count)
+				{
+					for (size_t k = 0; k < count; k++)
+						function(SNs[k]);
+				});
+		}
+
+		// Same SNs as ForEachCandidate, passed one row of cells at a time together with
+		// their positions so that the distances of a whole row can be computed at once.
+		template<typename TFunction>
+		inline void ForEachCandidateRun(double x, double y, double radius, TFunction function) const
+		{
+			if (m_X.empty())
+				return;
+
+			// Padded so that an SN at exactly radius is never lost to the rounding of x + radius.
+			double reach = radius + m_CellSize * 1e-6;
+			int64_t firstColumn = Column(x - reach);
+			int64_t lastColumn = Column(x + reach);
+			int64_t firstRow = Row(y - reach);
+			int64_t lastRow = Row(y + reach);
+
+			// The cells of a row are consecutive, so are their SNs.
+			for (int64_t row = firstRow; row <= lastRow; row++)
+			{
+				int64_t first = m_CellStart[row * m_Columns + firstColumn];
+				int64_t last = m_CellStart[row * m_Columns + lastColumn + 1];
+				if (first < last)
+					function(&m_CellSNs[first], &m_CellX[first], &m_CellY[first], (size_t)(last - first));
+			}
+		}
+
+	private:
+		inline int64_t Column(double x) const { return (int64_t)std::clamp(std::floor((x - m_MinX) / m_CellSize), 0.0, (double)(m_Columns - 1)); }
+		inline int64_t Row(double y) const { return (int64_t)std::clamp(std::floor((y - m_MinY) / m_CellSize), 0.0, (double)(m_Rows - 1)); }
+
+		std::vector<double> m_X;
+		std::vector<double> m_Y;
+
+		double m_MinX = 0.0;
+		double m_MinY = 0.0;
+		double m_CellSize = 1.0;
+		int64_t m_Columns = 0;
+		int64_t m_Rows = 0;
+
+		// SNs sorted by cell, the SNs of cell c are m_CellSNs[m_CellStart[c]] to m_CellSNs[m_CellStart[c + 1] - 1].
+		// m_CellX and m_CellY hold their positions in the same order.
+		std::vector<int64_t> m_CellStart;
+		std::vector<int64_t> m_CellSNs;
+		std::vector<double> m_CellX;
+		std::vector<double> m_CellY;
+	};
+}
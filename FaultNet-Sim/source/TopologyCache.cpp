@@ -0,0 +1,110 @@
+#include "PCH.h"
+#include "TopologyCache.h"
+
+namespace FaultNet_Sim
+{
+	TopologyCache::TopologyCache(const std::vector<SensorNode>& SNs)
+		: m_SpatialIndex(std::make_shared<SpatialIndex>(SNs)) {}
+
+	std::shared_ptr<const NeighborList> TopologyCache::GetNeighborList(double range)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_NeighborList && m_NeighborList->Range() >= range)
+				return m_NeighborList;
+		}
+
+		// Lists are never modified once built, simulators keep using the smaller one while it is extended.
+		std::lock_guard<std::mutex> extendLock(m_ExtendMutex);
+
+		std::shared_ptr<const NeighborList> previous;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (m_NeighborList && m_NeighborList->Range() >= range)
+				return m_NeighborList;
+			previous = m_NeighborList;
+		}
+
+		// Grows geometrically so that a sweep over many close ranges only extends the list a few times.
+		double extendedRange = previous ? std::max(range, previous->Range() * c_RangeGrowth) : range;
+		std::shared_ptr<const NeighborList> extended = std::make_shared<NeighborList>(*m_SpatialIndex, extendedRange, previous.get());
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_NeighborList = extended;
+		return extended;
+	}
+
+	std::shared_ptr<const InterferenceGraph> TopologyCache::GetInterferenceGraph(double interferenceRange)
+	{
+		std::promise<std::shared_ptr<const InterferenceGraph>> promise;
+		std::shared_future<std::shared_ptr<const InterferenceGraph>> graph;
+		bool isBuilder = false;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			auto it = m_InterferenceGraphs.find(interferenceRange);
+			if (it == m_InterferenceGraphs.end())
+			{
+				it = m_InterferenceGraphs.emplace(interferenceRange, promise.get_future().share()).first;
+				isBuilder = true;
+			}
+			graph = it->second;
+		}
+
+		// Built outside of the lock, simulators asking for other ranges do not wait for it.
+		if (isBuilder)
+		{
+			std::shared_ptr<InterferenceGraph> built = std::make_shared<InterferenceGraph>();
+			built->Build(*GetNeighborList(interferenceRange), interferenceRange);
+			promise.set_value(built);
+		}
+
+		return graph.get();
+	}
+
+	bool TopologyCache::ApplyTopology(const TopologyKey& key, std::vector<SensorNode>& SNs, const std::function<void()>& construct)
+	{
+		std::shared_ptr<Topology> topology;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			std::shared_ptr<Topology>& entry = m_Topologies[key];
+			if (!entry)
+				entry = std::make_shared<Topology>();
+			topology = entry;
+		}
+
+		std::lock_guard<std::mutex> lock(topology->Mutex);
+
+		if (topology->IsConstructed)
+		{
+			for (int i = 0; i < SNs.size(); i++)
+			{
+				SNs[i].m_Parent = topology->Parent[i];
+				SNs[i].m_Level = topology->Level[i];
+				SNs[i].m_Color = topology->Color[i];
+				SNs[i].m_ChildCount = topology->ChildCount[i];
+				SNs[i].m_DescendantCount = topology->DescendantCount[i];
+			}
+
+			return true;
+		}
+
+		construct();
+
+		topology->Parent.resize(SNs.size());
+		topology->Level.resize(SNs.size());
+		topology->Color.resize(SNs.size());
+		topology->ChildCount.resize(SNs.size());
+		topology->DescendantCount.resize(SNs.size());
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			topology->Parent[i] = SNs[i].m_Parent;
+			topology->Level[i] = SNs[i].m_Level;
+			topology->Color[i] = SNs[i].m_Color;
+			topology->ChildCount[i] = SNs[i].m_ChildCount;
+			topology->DescendantCount[i] = SNs[i].m_DescendantCount;
+		}
+		topology->IsConstructed = true;
+
+		return false;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "GraphColoring.h"
+
+namespace FaultNet_Sim
+{
+	// What ConstructTopology and ColorTopology produce for a simulator type and range pair,
+	// the coloring algorithm included since it changes the colors.
+	struct TopologyKey
+	{
+		std::type_index SimulatorType;
+		double TransmissionRange;
+		double InterferenceRange;
+		ColoringType Coloring;
+		uint64_t ColoringSeed;
+
+		bool operator<(const TopologyKey& other) const
+		{
+			return std::tie(SimulatorType, TransmissionRange, InterferenceRange, Coloring, ColoringSeed) <
+				std::tie(other.SimulatorType, other.TransmissionRange, other.InterferenceRange, other.Coloring, other.ColoringSeed);
+		}
+	};
+
+	// Spatial index, neighbor list, interference graphs and constructed topologies of the SNs of a problem,
+	// shared by all of its simulators so that simulators differing only in other parameters
+	// construct and color each topology once.
+	class TopologyCache
+	{
+	public:
+		TopologyCache(const std::vector<SensorNode>& SNs);
+
+		inline std::shared_ptr<const SpatialIndex> GetSpatialIndex() const { return m_SpatialIndex; }
+		// A list covering at least range. Asking for increasing ranges, as range sweeps do,
+		// extends the list with the new pairs instead of rebuilding it.
+		std::shared_ptr<const NeighborList> GetNeighborList(double range);
+		std::shared_ptr<const InterferenceGraph> GetInterferenceGraph(double interferenceRange);
+
+		// Copies the topology of key into SNs and returns true if it has been constructed,
+		// otherwise calls construct, which builds it in SNs, stores it and returns false.
+		// Simulators asking for a key under construction wait for it.
+		bool ApplyTopology(const TopologyKey& key, std::vector<SensorNode>& SNs, const std::function<void()>& construct);
+
+	private:
+		static constexpr double c_RangeGrowth = 1.25;
+
+		struct Topology
+		{
+			std::mutex Mutex;
+			bool IsConstructed = false;
+
+			std::vector<int64_t> Parent;
+			std::vector<int64_t> Level;
+			std::vector<int64_t> Color;
+			std::vector<int> ChildCount;
+			std::vector<int> DescendantCount;
+		};
+
+		std::shared_ptr<const SpatialIndex> m_SpatialIndex;
+
+		std::mutex m_Mutex;
+		std::mutex m_ExtendMutex;
+		std::shared_ptr<const NeighborList> m_NeighborList;
+		std::map<double, std::shared_future<std::shared_ptr<const InterferenceGraph>>> m_InterferenceGraphs;
+		std::map<TopologyKey, std::shared_ptr<Topology>> m_Topologies;
+	};
+}
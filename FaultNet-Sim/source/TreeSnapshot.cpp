@@ -0,0 +1,65 @@
+#include "PCH.h"
+#include "TreeSnapshot.h"
+
+namespace FaultNet_Sim
+{
+	bool TreeSnapshot::operator==(const TreeSnapshot& other) const
+	{
+		if (m_SNs != other.m_SNs || m_Batches.size() != other.m_Batches.size())
+			return false;
+
+		for (int i = 0; i < m_Batches.size(); i++)
+		{
+			const PacketBatch& a = m_Batches[i];
+			const PacketBatch& b = other.m_Batches[i];
+			if (a.InitialSNID != b.InitialSNID || a.Count != b.Count || a.InitialTimestampSum != b.InitialTimestampSum || a.SizeSum != b.SizeSum)
+				return false;
+		}
+
+		return true;
+	}
+
+	TreeAccumulators::TreeAccumulators(size_t count)
+		: m_CollectionTime(count, 0.0), m_WastedTime(count, 0.0), m_EnergyConsumed(count, 0.0), m_EnergyWasted(count, 0.0),
+		m_SentPacketTotalDelay(count, 0.0), m_SentPacketCount(count, 0), m_TotalDataSent(count, 0.0) {}
+
+	void TreeAccumulators::Fold(const std::vector<int64_t>& SNs, SensorNodeTable& snt, int64_t repetitions)
+	{
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			int64_t sn = SNs[i];
+
+			m_CollectionTime[i] += repetitions * snt.m_CollectionTime[sn];
+			m_WastedTime[i] += repetitions * snt.m_WastedTime[sn];
+			m_EnergyConsumed[i] += repetitions * snt.m_EnergyConsumed[sn];
+			m_EnergyWasted[i] += repetitions * snt.m_EnergyWasted[sn];
+			m_SentPacketTotalDelay[i] += repetitions * snt.m_SentPacketTotalDelay[sn];
+			m_SentPacketCount[i] += repetitions * snt.m_SentPacketCount[sn];
+			m_TotalDataSent[i] += repetitions * snt.m_TotalDataSent[sn];
+
+			snt.m_CollectionTime[sn] = 0.0;
+			snt.m_WastedTime[sn] = 0.0;
+			snt.m_EnergyConsumed[sn] = 0.0;
+			snt.m_EnergyWasted[sn] = 0.0;
+			snt.m_SentPacketTotalDelay[sn] = 0.0;
+			snt.m_SentPacketCount[sn] = 0;
+			snt.m_TotalDataSent[sn] = 0.0;
+		}
+	}
+
+	void TreeAccumulators::Restore(const std::vector<int64_t>& SNs, SensorNodeTable& snt) const
+	{
+		for (int i = 0; i < SNs.size(); i++)
+		{
+			int64_t sn = SNs[i];
+
+			snt.m_CollectionTime[sn] += m_CollectionTime[i];
+			snt.m_WastedTime[sn] += m_WastedTime[i];
+			snt.m_EnergyConsumed[sn] += m_EnergyConsumed[i];
+			snt.m_EnergyWasted[sn] += m_EnergyWasted[i];
+			snt.m_SentPacketTotalDelay[sn] += m_SentPacketTotalDelay[i];
+			snt.m_SentPacketCount[sn] += m_SentPacketCount[i];
+			snt.m_TotalDataSent[sn] += m_TotalDataSent[i];
+		}
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "SensorNodeTable.h"
+#include "PacketStore.h"
+#include "EventQueue.h"
+
+namespace FaultNet_Sim
+{
+	// State of the SNs of one routing tree taken at a superslot boundary, with all
+	// timestamps relative to the boundary. If two consecutive snapshots are equal,
+	// the tree repeats the last superslot until one of its SNs fails.
+	class TreeSnapshot
+	{
+	public:
+		template<typename TPacketStore>
+		void Capture(const std::vector<int64_t>& SNs, const SensorNodeTable& snt, const std::vector<WorkingStateTimestamp>& pendingEvents, const TPacketStore& packetStore, double boundary)
+		{
+			m_SNs.clear();
+			m_Batches.clear();
+
+			for (int64_t sn : SNs)
+			{
+				size_t batchBegin = m_Batches.size();
+				packetStore.ForEachBatch(sn, [&](const PacketBatch& batch)
+					{
+						m_Batches.push_back({ batch.InitialSNID, batch.Count, batch.InitialTimestampSum - batch.Count * boundary, batch.SizeSum });
+					});
+
+				m_SNs.push_back({
+					snt.m_PreviousState[sn],
+					snt.m_PreviousTimestamp[sn] - boundary,
+					snt.m_CurrentData[sn],
+					pendingEvents[sn].State,
+					pendingEvents[sn].Timestamp - boundary,
+					snt.m_Failures[sn].Index(),
+					(int64_t)(m_Batches.size() - batchBegin)
+				});
+			}
+		}
+
+		bool operator==(const TreeSnapshot& other) const;
+
+	private:
+		struct SNSnapshot
+		{
+			WorkingState PreviousState;
+			double PreviousTimestamp;
+			double CurrentData;
+			WorkingState PendingState;
+			double PendingTimestamp;
+			int64_t FailureIterator;
+			int64_t BatchCount;
+
+			bool operator==(const SNSnapshot& other) const = default;
+		};
+
+		std::vector<SNSnapshot> m_SNs;
+		std::vector<PacketBatch> m_Batches;
+	};
+
+	// Results of the SNs of one routing tree up to the last superslot boundary.
+	// Fold moves what the table accumulated since then into the totals, counting
+	// it once per repetition of the superslot, and Restore writes the totals back.
+	class TreeAccumulators
+	{
+	public:
+		TreeAccumulators(size_t count);
+
+		void Fold(const std::vector<int64_t>& SNs, SensorNodeTable& snt, int64_t repetitions);
+		void Restore(const std::vector<int64_t>& SNs, SensorNodeTable& snt) const;
+
+	private:
+		std::vector<double> m_CollectionTime;
+		std::vector<double> m_WastedTime;
+		std::vector<double> m_EnergyConsumed;
+		std::vector<double> m_EnergyWasted;
+		std::vector<double> m_SentPacketTotalDelay;
+		std::vector<int64_t> m_SentPacketCount;
+		std::vector<double> m_TotalDataSent;
+	};
+}